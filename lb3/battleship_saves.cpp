@@ -0,0 +1,246 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <map>
+#include <cstdio>
+#include "Game.h"
+#include "SaveImage.h"
+#include "BinarySave.h"
+#include "SaveJournal.h"
+#include "SaveSaxLoader.h"
+#include "JsonSaveWriter.h"
+#include "FileHandler.h"
+#include "FileExeption.h"
+
+/// g++ -std=c++17 -O2 -pthread -I lb3/include lb3/battleship_saves.cpp lb3/source/GameField.cpp lb3/source/Ship.cpp lb3/source/ShipManager.cpp lb3/source/Bombardment.cpp lb3/source/DoubleDamage.cpp lb3/source/Scanner.cpp lb3/source/AbilityManager.cpp lb3/source/Game.cpp lb3/source/FileHandler.cpp lb3/source/FileExeption.cpp lb3/source/GameState.cpp lb3/source/LiveSegmentIndex.cpp lb3/source/ProbabilityMap.cpp lb3/source/EnemyAI.cpp lb3/source/MctsAI.cpp lb3/source/SaveImage.cpp lb3/source/BinarySave.cpp lb3/source/SaveSaxLoader.cpp lb3/source/JsonSaveWriter.cpp lb3/source/SaveJournal.cpp lb3/source/AsyncSaver.cpp lb3/source/SaveArchive.cpp lb3/source/FieldCodec.cpp lb3/source/GameStateView.cpp lb3/source/BoardRenderer.cpp lb3/source/AnsiDiffRenderer.cpp lb3/source/PlayerInput.cpp lb3/source/ConsolePolicies.cpp lb3/source/ShipSpatialIndex.cpp -o build_lb/battleship-saves
+//
+// Массовая проверка и перевод сохранений между форматами.
+//   battleship-saves validate <каталог> [--threads N] [--index файл]
+//   battleship-saves convert <каталог> <новый каталог> --to json|binary [--threads N] [--index файл]
+// Каждое сохранение читается, проверяется восстановлением Game и получает заново посчитанный хеш состояния.
+// Файлы раздаются потокам по одному, поэтому в памяти одновременно не больше одного сохранения на поток.
+// Индекс - текстовый файл, строка на сохранение: путь, формат, раунд, хеш, "ok" или текст ошибки.
+
+namespace fs = std::filesystem;
+
+struct SaveEntry {
+    fs::path path;       // относительно исходного каталога
+    fs::path output;     // куда пишет convert, выбирается до раздачи работы потокам
+    std::string format;
+    int round = 0;
+    std::uint64_t hash = 0;
+    std::string error;   // пусто - сохранение в порядке
+};
+
+struct Options {
+    std::string command;
+    fs::path source;
+    fs::path target;
+    SaveFormat to = SaveFormat::Auto;
+    int threads = 0;
+    fs::path index;
+};
+
+static std::vector<std::uint8_t> readFile(const fs::path& path) {
+    std::vector<std::uint8_t> data;
+    FileHandler file_handler(path.string());
+    file_handler.openForRead();
+    file_handler.readBytes(data);
+    file_handler.closeRead();
+    return data;
+}
+
+static SaveImage readImage(const std::vector<std::uint8_t>& data, std::string& format) {
+    if (BinarySave::isBinary(data)) {
+        format = "binary";
+        return BinarySave::decode(data);
+    }
+    if (SaveJournal::isJournal(data)) {
+        format = "journal";
+        Game replayed = SaveJournal::replay(data);
+        return SaveImage::capture(replayed);
+    }
+    format = "json";
+    return SaveSaxLoader::parse(data);
+}
+
+static void processSave(const Options& options, SaveEntry& entry, JsonSaveWriter& writer) {
+    try {
+        SaveImage image = readImage(readFile(options.source / entry.path), entry.format);
+        Game game = image.restore(); // restore() проверяет согласованность сохранения
+        entry.round = game.getRoundCounter();
+        entry.hash = game.getStateHash();
+        if (options.command != "convert") {
+            return;
+        }
+
+        fs::path output = options.target / entry.output;
+        fs::create_directories(output.parent_path());
+        FileHandler file_handler(output.string());
+        file_handler.openForWrite();
+        if (options.to == SaveFormat::Binary) {
+            file_handler.writeBytes(BinarySave::encode(image));
+        } else {
+            file_handler.writeText(writer.write(image));
+        }
+        file_handler.closeWrite();
+    } catch (const FileExeption& e) {
+        entry.error = e.what();
+    } catch (const std::exception& e) {
+        entry.error = e.what();
+    }
+}
+
+// Выходные пути convert. Обычно расширение заменяется (a.json -> a.bin), но если так совпадут
+// пути нескольких сохранений (a.json и a.journal), им оставляется исходное расширение (a.json.bin).
+// Совпадения, которые остались и после этого, считаются ошибкой сохранения, а не перезаписью.
+static void assignOutputs(const Options& options, std::vector<SaveEntry>& entries) {
+    std::string extension = options.to == SaveFormat::Binary ? ".bin" : ".json";
+    std::map<fs::path, int> uses;
+    for (SaveEntry& entry : entries) {
+        entry.output = entry.path;
+        entry.output.replace_extension(extension);
+        ++uses[entry.output];
+    }
+    for (SaveEntry& entry : entries) {
+        if (uses[entry.output] > 1) {
+            entry.output = entry.path;
+            entry.output += extension;
+        }
+    }
+
+    std::map<fs::path, const SaveEntry*> owners;
+    for (SaveEntry& entry : entries) {
+        auto [owner, inserted] = owners.emplace(entry.output, &entry);
+        if (!inserted) {
+            entry.error = "Output path " + entry.output.generic_string() + " is already used by " +
+                          owner->second->path.generic_string();
+        }
+    }
+}
+
+static void writeIndex(const fs::path& file_name, const std::vector<SaveEntry>& entries) {
+    std::ofstream index(file_name);
+    if (!index.is_open()) {
+        throw FileExeption("Can't open index for writing.");
+    }
+    char hash[17];
+    for (const SaveEntry& entry : entries) {
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(entry.hash));
+        index << entry.path.generic_string() << '\t' << entry.format << '\t' << entry.round << '\t' << hash << '\t'
+              << (entry.error.empty() ? "ok" : entry.error) << '\n';
+    }
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    if (argc < 3) {
+        return false;
+    }
+    options.command = argv[1];
+    options.source = argv[2];
+    int i = 3;
+    if (options.command == "convert") {
+        if (argc < 4) {
+            return false;
+        }
+        options.target = argv[3];
+        i = 4;
+    } else if (options.command != "validate") {
+        return false;
+    }
+    for (; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--threads") {
+            options.threads = std::stoi(value);
+        } else if (option == "--index") {
+            options.index = value;
+        } else if (option == "--to") {
+            if (value == "json") options.to = SaveFormat::Json;
+            if (value == "binary") options.to = SaveFormat::Binary;
+        } else {
+            return false;
+        }
+    }
+    if (i != argc) {
+        return false;
+    }
+    return options.command != "convert" || options.to != SaveFormat::Auto;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            std::cerr << "Usage: battleship-saves validate <dir> [--threads N] [--index file]\n"
+                      << "       battleship-saves convert <dir> <new dir> --to json|binary [--threads N] [--index file]\n";
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option value: " << e.what() << "\n";
+        return 2;
+    }
+
+    std::vector<SaveEntry> entries;
+    try {
+        for (const fs::directory_entry& file : fs::recursive_directory_iterator(options.source)) {
+            if (file.is_regular_file()) {
+                SaveEntry entry;
+                entry.path = fs::relative(file.path(), options.source);
+                entries.push_back(std::move(entry));
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Can't list saves: " << e.what() << "\n";
+        return 1;
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const SaveEntry& a, const SaveEntry& b) { return a.path < b.path; });
+
+    if (options.command == "convert") {
+        assignOutputs(options, entries);
+    }
+
+    int thread_count = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<std::size_t> next {0};
+    auto work = [&]() {
+        JsonSaveWriter writer; // буфер свой у каждого потока
+        for (std::size_t i = next++; i < entries.size(); i = next++) {
+            if (entries[i].error.empty()) {
+                processSave(options, entries[i], writer);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < thread_count; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    int failed = 0;
+    for (const SaveEntry& entry : entries) {
+        if (!entry.error.empty()) {
+            ++failed;
+            std::cerr << entry.path.generic_string() << ": " << entry.error << "\n";
+        }
+    }
+    if (!options.index.empty()) {
+        try {
+            writeIndex(options.index, entries);
+        } catch (const FileExeption& e) {
+            std::cerr << "Error while writing index: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    std::cout << "Processed " << entries.size() << " saves: " << entries.size() - failed << " ok, "
+              << failed << " failed\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SimulationPolicies.h"
+
+/// g++ -std=c++17 -O2 -I lb3/include lb3/battleship_simulate.cpp lb3/source/GameField.cpp lb3/source/Ship.cpp lb3/source/ShipManager.cpp lb3/source/LiveSegmentIndex.cpp lb3/source/ShipSpatialIndex.cpp lb3/source/AbilityManager.cpp lb3/source/Bombardment.cpp lb3/source/DoubleDamage.cpp lb3/source/Scanner.cpp lb3/source/BoardRenderer.cpp -o build_lb/battleship-simulate
+//
+// Безголовые прогоны SimulationGame: те же правила, что у консольной игры, без ввода-вывода и журнала.
+//   battleship-simulate selfplay [партий] [--seed N] [--size N]
+//   battleship-simulate large [раундов] [--seed N] [--size N] [--ships N]
+// selfplay: обе стороны играют HuntEnemy на случайной расстановке классического флота. Все случайные числа
+// идут из FastRng партии (seed + номер партии), поэтому одинаковый seed дает одинаковый итоговый хеш.
+// large: одна партия на огромном поле (по умолчанию 4096x4096, 2000 кораблей длиной 1-4) в режимах
+// FieldMode::Large и FieldMode::Sparse с одним seed: память клеток поля бота после расстановки и после
+// игры, время и хеш состояния. Хеши режимов должны совпасть, иначе программа возвращает 1.
+
+constexpr int roundLimit = 10000; // партия без победителя за столько раундов считается ничьей
+
+std::string parseOption(int argc, char* argv[], const std::string& name, const std::string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) {
+            return argv[i + 1];
+        }
+    }
+    return fallback;
+}
+
+int selfPlay(int argc, char* argv[]) {
+    int games = argc > 2 && argv[2][0] != '-' ? std::stoi(argv[2]) : 10000;
+    std::uint64_t seed = std::stoull(parseOption(argc, argv, "--seed", "1"));
+    int size = std::stoi(parseOption(argc, argv, "--size", std::to_string(classicFieldSize)));
+    const std::vector<int> fleet = {4, 3, 3, 2, 2, 2, 1, 1, 1, 1};
+
+    int player_wins = 0;
+    int draws = 0;
+    long long rounds = 0;
+    std::uint64_t hash = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < games; ++i) {
+        SimulationGame game;
+        game.getRng() = FastRng(seed + i);
+        game.arrangeRandomly(size, size, fleet);
+        HuntEnemy player_side;
+        if (game.playAutomatic(player_side, roundLimit)) {
+            ++player_wins;
+        } else if (game.getPlayerShipManager().getAliveShipsNumber() > 0) {
+            ++draws;
+        }
+        rounds += game.getRoundCounter();
+        hash = Zobrist::rotate(hash, 7) ^ game.getStateHash();
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << games << " games on " << size << "x" << size << ": player " << player_wins << ", bot "
+              << games - player_wins - draws << ", draws " << draws << "\n";
+    std::cout << "average rounds " << (games > 0 ? static_cast<double>(rounds) / games : 0.0) << ", "
+              << (games > 0 ? elapsed / games : 0.0) << " us per game\n";
+    std::cout << "state hash " << std::hex << hash << std::dec << "\n";
+    return 0;
+}
+
+int largeBoard(int argc, char* argv[]) {
+    int rounds = argc > 2 && argv[2][0] != '-' ? std::stoi(argv[2]) : 20000;
+    std::uint64_t seed = std::stoull(parseOption(argc, argv, "--seed", "77"));
+    int size = std::stoi(parseOption(argc, argv, "--size", std::to_string(maximalLargeFieldSize)));
+    int ship_count = std::stoi(parseOption(argc, argv, "--ships", "2000"));
+    std::vector<int> fleet;
+    for (int i = 0; i < ship_count; ++i) {
+        fleet.push_back(1 + i % maximalShipLength);
+    }
+
+    struct Run {
+        const char* name;
+        FieldMode mode;
+        std::uint64_t hash = 0;
+    };
+    Run runs[] = {{"large", FieldMode::Large}, {"sparse", FieldMode::Sparse}};
+    for (Run& run : runs) {
+        SimulationGame game;
+        game.getRng() = FastRng(seed);
+        auto start = std::chrono::steady_clock::now();
+        game.arrangeRandomly(size, size, fleet, run.mode);
+        std::size_t arranged = game.getEnemyField().getStorageBytes();
+        HuntEnemy player_side;
+        game.playAutomatic(player_side, rounds);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        run.hash = game.getStateHash();
+
+        std::cout << run.name << ": " << size << "x" << size << ", " << ship_count << " ships, "
+                  << game.getRoundCounter() << " rounds, " << elapsed << " ms\n";
+        std::cout << "  bot field cells " << arranged / 1024 << " KB after arrangement, "
+                  << game.getEnemyField().getStorageBytes() / 1024 << " KB after play\n";
+        std::cout << "  ships alive: player " << game.getPlayerShipManager().getAliveShipsNumber() << ", bot "
+                  << game.getEnemyShipManager().getAliveShipsNumber() << ", state hash " << std::hex << run.hash
+                  << std::dec << "\n";
+    }
+    if (runs[0].hash != runs[1].hash) {
+        std::cout << "State hashes differ between field modes\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+    try {
+        if (command == "selfplay") {
+            return selfPlay(argc, argv);
+        }
+        if (command == "large") {
+            return largeBoard(argc, argv);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << "Usage: battleship-simulate selfplay [games] [--seed N] [--size N]\n"
+              << "       battleship-simulate large [rounds] [--seed N] [--size N] [--ships N]\n";
+    return 2;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "FieldCodec.h"
+
+/// g++ -std=c++17 -O2 -I lb3/include lb3/field_codec_bench.cpp lb3/source/FieldCodec.cpp -o build_lb/field-codec-bench
+//
+// Замер FieldCodec на наибольшем поле (25x25): упаковка и распаковка текстовой формы (base64, как в JSON)
+// и двоичного потока. Поля - от пустого до позднего этапа игры. Цель - меньше микросекунды на
+// упаковку и распаковку вместе; при превышении программа возвращает 1.
+//   field-codec-bench [повторов]
+
+constexpr double targetMicroseconds = 1.0;
+
+// Поле после shots выстрелов: промахи и попадания (примерно каждое пятое) в случайных клетках
+static std::vector<Status> playedField(int shots, std::mt19937& rng) {
+    std::vector<Status> cells(maximalFieldSize * maximalFieldSize, Status::Unknown);
+    for (int i = 0; i < shots; ++i) {
+        cells[rng() % cells.size()] = rng() % 5 == 0 ? Status::Ship : Status::Empty;
+    }
+    return cells;
+}
+
+// Лучшее среднее из нескольких серий: чужие процессы и частота процессора меньше влияют на результат
+template <typename Run>
+static double microseconds(int repeats, Run run) {
+    constexpr int rounds = 10;
+    double best = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats / rounds; ++i) {
+            run();
+        }
+        double average = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+                         (repeats / rounds);
+        best = round == 0 || average < best ? average : best;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int repeats = argc > 1 ? std::stoi(argv[1]) : 200000;
+    std::mt19937 rng(2024);
+    struct Case {
+        const char* name;
+        int shots;
+    };
+    const Case cases[] = {{"empty", 0}, {"30 shots", 30}, {"100 shots", 100}, {"late game", 450}};
+
+    bool slow = false;
+    std::string text;
+    std::vector<std::uint8_t> bytes;
+    std::vector<Status> decoded(maximalFieldSize * maximalFieldSize);
+    for (const Case& test : cases) {
+        std::vector<Status> cells = playedField(test.shots, rng);
+        double text_time = microseconds(repeats, [&]() {
+            text.clear();
+            FieldCodec::encodeText(cells.data(), cells.size(), text);
+            FieldCodec::decodeText(text, decoded.data(), decoded.size());
+        });
+        if (decoded != cells) {
+            std::cerr << test.name << ": text round trip changed the field\n";
+            return 2;
+        }
+        double binary_time = microseconds(repeats, [&]() {
+            bytes.clear();
+            FieldCodec::encode(cells.data(), cells.size(), bytes);
+            FieldCodec::decode(bytes.data(), bytes.size(), decoded.data(), decoded.size());
+        });
+        if (decoded != cells) {
+            std::cerr << test.name << ": binary round trip changed the field\n";
+            return 2;
+        }
+        std::cout << test.name << ": text " << text_time << " us (" << text.size() << " chars), binary "
+                  << binary_time << " us (" << bytes.size() << " bytes)\n";
+        slow = slow || text_time > targetMicroseconds || binary_time > targetMicroseconds;
+    }
+    if (slow) {
+        std::cout << "Slower than " << targetMicroseconds << " us per encode + decode\n";
+        return 1;
+    }
+    return 0;
+}
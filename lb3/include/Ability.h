@@ -13,9 +13,24 @@ public:
     NoAvailableAbilitiesException() : std::runtime_error("No available abilities to apply.") {}
 };
 
+enum class AbilityKind { DoubleDamage, Scanner, Bombardment };
+
+constexpr int abilityKindCount = 3;
+
+// Имя способности в сохранениях, совпадает с Ability::getName
+inline const char* abilityKindName(AbilityKind kind) {
+    switch (kind) {
+    case AbilityKind::DoubleDamage: return "DoubleDamage";
+    case AbilityKind::Scanner: return "Scanner";
+    case AbilityKind::Bombardment: return "Bombardment";
+    }
+    return "";
+}
+
 class Ability {
 public:
     virtual void apply(GameField& field, ShipManager& manager, Coords coords) = 0;
     virtual std::string getName() const = 0;
+    virtual AbilityKind getKind() const = 0;
     virtual ~Ability() = default;
 };
\ No newline at end of file
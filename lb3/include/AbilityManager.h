@@ -9,16 +9,28 @@ class AbilityManager {
 private:
     std::deque<std::unique_ptr<Ability>> abilityQueue;
     std::vector<std::unique_ptr<Ability>> allAbilities;
+    // Полиномиальный хеш очереди: сумма ключей способностей с весами queueBase^i.
+    // Добавление в конец и извлечение из начала пересчитывают его за O(1).
+    std::uint64_t queue_hash = 0;
+    std::uint64_t queue_power = 1;
+
+    void hashPushBack(const Ability& ability);
+    void hashPopFront(const Ability& ability);
 
 public:
-    AbilityManager();
+    AbilityManager(); // одна способность через rand(); BasicGame выдает стартовые способности из своего Rng
     AbilityManager(AbilityManager&& other) noexcept;
     AbilityManager& operator=(AbilityManager&& other) noexcept;
     AbilityManager(std::deque<std::unique_ptr<Ability>>&& initialQueue);
 
+    static std::unique_ptr<Ability> createAbility(AbilityKind kind);
+
     void grantRandomAbility();
-    void applyAbility(GameField& field, ShipManager& manager, Coords coords);
+    std::unique_ptr<Ability> takeAbility(); // снять способность с очереди без применения
+    std::unique_ptr<Ability> applyAbility(GameField& field, ShipManager& manager, Coords coords);
     void addAbility(std::unique_ptr<Ability> ability);
     void printAbilities() const;
     const std::deque<std::unique_ptr<Ability>>& getQueue() const;
+    std::vector<AbilityKind> getQueueKinds() const;
+    std::uint64_t getHash() const;
 };
\ No newline at end of file
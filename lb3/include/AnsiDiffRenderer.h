@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "BoardRenderer.h"
+
+// Вывод полей для ANSI-терминала с обновлением только изменившихся клеток.
+// Первый кадр очищает экран и рисуется целиком в верхних строках (раскладка BoardRenderer);
+// дальше для каждой клетки, чей символ отличается от выведенного, выводится
+// перемещение курсора и новый символ. Сравнение идет с последним выведенным кадром,
+// а не со списком атакованных клеток: обстрел меняет сегменты мимо поля.
+// После обновления курсор встает под кадр и очищает экран ниже, поэтому подсказки
+// хода не прокручивают экран и кадр остается на месте.
+class AnsiDiffRenderer {
+private:
+    BoardRenderer full;
+    std::string out;
+    std::vector<char> player_shadow; // символы, которые сейчас на экране
+    std::vector<char> enemy_shadow;
+    int player_width = -1;
+    int player_height = -1;
+    int enemy_width = -1;
+    int enemy_height = -1;
+    std::string ability_line;
+
+    void moveTo(int row, int column); // с нуля, от левого верхнего угла
+    void diffBoard(const GameField& field, std::vector<char>& shadow, int left);
+    static void snapshot(const GameField& field, std::vector<char>& shadow);
+    int frameRows() const;
+
+public:
+    const std::string& update(const GameField& player, const GameField& enemy, const AbilityManager& abilities);
+    void invalidate(); // следующий кадр - целиком (например, экран мог быть очищен)
+    void emit() const;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "SaveImage.h"
+#include "JsonSaveWriter.h"
+
+// Фоновое сохранение: ход снимает SaveImage (плоская копия состояния) и отдает его потоку записи.
+// Поток забирает все накопившиеся задания разом, кодирует их и пишет через временный файл,
+// fsync и rename. Задание, которое еще ждет в очереди, заменяется более новым снимком того же файла,
+// поэтому при сохранении на каждом ходу на диск попадает только последнее состояние.
+// Завершение сообщается через future и, если задан, через callback (вызывается в потоке записи).
+// Поддерживаются форматы Json и Binary; журнал дописывается синхронно, он зависит от состояния Game.
+class AsyncSaver {
+public:
+    using Callback = std::function<void(const std::string& file_name, bool saved)>;
+
+private:
+    struct Job {
+        std::string file_name;
+        SaveFormat format = SaveFormat::Json;
+        SaveImage image;
+        std::vector<std::promise<bool>> promises;
+        std::vector<Callback> callbacks;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    bool busy = false;
+    bool stopping = false;
+    JsonSaveWriter writer; // используется только потоком записи
+    std::thread worker;
+
+    void run();
+    bool write(Job& job);
+
+public:
+    AsyncSaver();
+    ~AsyncSaver(); // дописывает очередь и останавливает поток
+    AsyncSaver(const AsyncSaver&) = delete;
+    AsyncSaver& operator=(const AsyncSaver&) = delete;
+
+    std::shared_future<bool> submit(const std::string& file_name, SaveFormat format, SaveImage image,
+                                    Callback done = nullptr);
+    void flush(); // ждать, пока все поставленные задания будут записаны
+
+    static AsyncSaver& shared();
+};
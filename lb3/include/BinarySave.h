@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "SaveImage.h"
+
+// Двоичный формат сохранения.
+// Заголовок: сигнатура "BSAV", версия (u16), номер раунда (u32), флаги хода (u8).
+// Для каждой стороны (игрок, бот): ширина и высота (u16), клетки поля - поток FieldCodec
+// (в версии 1 - две битовые плоскости: клетка открыта / в клетке корабль), число кораблей (u16) и записи по 6 байт:
+// x, y (u16), ориентация и длина (u8), статусы сегментов по 2 бита (u8);
+// затем число способностей (u16) и их коды (u8). В конце - контрольная сумма FNV-1a (u32).
+// Все числа записываются в little-endian.
+class BinarySave {
+public:
+    static constexpr std::uint16_t version = 2; // версия 1 читается
+
+    static std::vector<std::uint8_t> encode(const SaveImage& image);
+    static SaveImage decode(const std::vector<std::uint8_t>& data);
+    static SaveImage decode(const std::uint8_t* data, std::size_t size); // например, запись в отображенном архиве
+    // Только раунд и флаги хода, без проверки контрольной суммы и разбора сторон
+    static SaveImage decodeHeader(const std::uint8_t* data, std::size_t size);
+    static bool isBinary(const std::vector<std::uint8_t>& data);
+    static std::uint32_t checksum(const std::uint8_t* data, std::size_t size);
+};
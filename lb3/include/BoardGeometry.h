@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "GameField.h"
+
+// Размеры поля как политика для горячих циклов по клеткам.
+// StaticGeometry знает размеры при компиляции: циклы разворачиваются, проверки границ сворачиваются,
+// деление на ширину становится умножением, а массивы клеток имеют фиксированный размер и живут на стеке.
+// DynamicGeometry - запасной вариант для полей произвольного размера.
+template <int W, int H>
+class StaticGeometry {
+public:
+    template <typename T>
+    using Cells = std::array<T, W * H>;
+
+    constexpr StaticGeometry() = default;
+
+    static constexpr int width() {
+        return W;
+    }
+
+    static constexpr int height() {
+        return H;
+    }
+
+    static constexpr int cells() {
+        return W * H;
+    }
+
+    static constexpr bool contains(Coords coords) {
+        return coords.x >= 0 && coords.x < W && coords.y >= 0 && coords.y < H;
+    }
+
+    static constexpr int index(Coords coords) {
+        return coords.y * W + coords.x;
+    }
+
+    static constexpr Coords coords(int index) {
+        return {index % W, index / W};
+    }
+
+    template <typename T>
+    static Cells<T> makeCells(T value) {
+        Cells<T> cells;
+        cells.fill(value);
+        return cells;
+    }
+};
+
+class DynamicGeometry {
+private:
+    int w;
+    int h;
+
+public:
+    template <typename T>
+    using Cells = std::vector<T>;
+
+    DynamicGeometry(int width, int height) : w(width), h(height) {}
+
+    int width() const {
+        return w;
+    }
+
+    int height() const {
+        return h;
+    }
+
+    int cells() const {
+        return w * h;
+    }
+
+    bool contains(Coords coords) const {
+        return coords.x >= 0 && coords.x < w && coords.y >= 0 && coords.y < h;
+    }
+
+    int index(Coords coords) const {
+        return coords.y * w + coords.x;
+    }
+
+    Coords coords(int index) const {
+        return {index % w, index / w};
+    }
+
+    template <typename T>
+    Cells<T> makeCells(T value) const {
+        return Cells<T>(cells(), value);
+    }
+};
+
+using ClassicGeometry = StaticGeometry<classicFieldSize, classicFieldSize>;
+
+// Вызывает run с политикой, подходящей полю: для классического поля - со статической,
+// для остальных - с динамической. Тело run компилируется для обеих.
+template <typename Run>
+auto withGeometry(int width, int height, Run run) {
+    if (width == classicFieldSize && height == classicFieldSize) {
+        return run(ClassicGeometry());
+    }
+    return run(DynamicGeometry(width, height));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include "GameField.h"
+#include "AbilityManager.h"
+
+// Вывод полей в консоль одним блоком: кадр собирается в буфер, который переиспользуется
+// между ходами, и выводится одним вызовом write. Обозначения клеток как в print_field:
+// 2 - целый сегмент, 1 - поврежденный, 0 - уничтоженный, x - промах, . - остальное.
+class BoardRenderer {
+private:
+    std::string frame;
+
+    void appendNumber(int value, int width);
+    void appendPadded(const char* text, int width);
+    void boardHeader(const GameField& field);
+    void boardRow(const GameField& field, int y);
+
+public:
+    static constexpr int gap = 4; // пробелы между полями в кадре
+
+    static char glyph(const Cell& cell);
+    // Раскладка кадра: ширина поля с подписями и столбец клетки x от левого края поля (с нуля)
+    static int boardWidth(const GameField& field);
+    static int cellColumn(const GameField& field, int x);
+    static std::string abilitiesLine(const AbilityManager& abilities);
+    static void write(const std::string& text); // один вызов write после сброса cout
+
+    // Одно поле с координатами
+    const std::string& board(const GameField& field);
+    // Поле игрока и поле врага рядом, под ними очередь способностей игрока
+    const std::string& frameFor(const GameField& player, const GameField& enemy, const AbilityManager& abilities);
+    const std::string& getFrame() const;
+    void emit() const;
+};
@@ -3,7 +3,15 @@
 #include "Ability.h"
 
 class Bombardment : public Ability {
+private:
+    bool hit = false;          // был ли поврежден сегмент при последнем применении
+    Coords hit_coords {0, 0};  // его клетка
+    bool preset = false;       // цель задана заранее (BasicGame или воспроизведение журнала), иначе - rand()
+
 public:
     void apply(GameField& field, ShipManager& manager, Coords coords) override;
     std::string getName() const override;
+    AbilityKind getKind() const override;
+    bool getHit(Coords& coords) const;
+    void presetTarget(Coords coords);
 };
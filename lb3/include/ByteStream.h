@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+// Чтение и запись чисел little-endian для двоичных форматов сохранений
+class ByteWriter {
+private:
+    std::vector<std::uint8_t>& out;
+
+public:
+    explicit ByteWriter(std::vector<std::uint8_t>& out) : out(out) {}
+
+    void u8(int value) {
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void u16(int value) {
+        if (value < 0 || value > 0xFFFF) {
+            throw std::runtime_error("Value does not fit into binary save");
+        }
+        u8(value & 0xFF);
+        u8(value >> 8);
+    }
+
+    void u32(std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            u8((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void bytes(const std::vector<std::uint8_t>& data) {
+        out.insert(out.end(), data.begin(), data.end());
+    }
+
+    void u64(std::uint64_t value) {
+        u32(static_cast<std::uint32_t>(value));
+        u32(static_cast<std::uint32_t>(value >> 32));
+    }
+};
+
+class ByteReader {
+private:
+    const std::uint8_t* in;
+    std::size_t position;
+    std::size_t end;
+
+public:
+    ByteReader(const std::uint8_t* in, std::size_t position, std::size_t end)
+        : in(in), position(position), end(end) {}
+    ByteReader(const std::vector<std::uint8_t>& in, std::size_t position, std::size_t end)
+        : ByteReader(in.data(), position, end) {}
+
+    int u8() {
+        if (position >= end) {
+            throw std::runtime_error("Binary save is truncated");
+        }
+        return in[position++];
+    }
+
+    int u16() {
+        int low = u8();
+        return low | u8() << 8;
+    }
+
+    std::uint32_t u32() {
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<std::uint32_t>(u8()) << (8 * i);
+        }
+        return value;
+    }
+
+    std::uint64_t u64() {
+        std::uint64_t low = u32();
+        return low | static_cast<std::uint64_t>(u32()) << 32;
+    }
+
+    const std::uint8_t* bytes(std::size_t count) {
+        if (count > end - position) {
+            throw std::runtime_error("Binary save is truncated");
+        }
+        const std::uint8_t* start = in + position;
+        position += count;
+        return start;
+    }
+
+    const std::uint8_t* current() const {
+        return in + position;
+    }
+
+    std::size_t remaining() const {
+        return end - position;
+    }
+
+    std::size_t getPosition() const {
+        return position;
+    }
+
+    bool atEnd() const {
+        return position == end;
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include "EnemyAI.h"
+#include "MctsAI.h"
+#include "BoardRenderer.h"
+#include "AnsiDiffRenderer.h"
+#include "PlayerInput.h"
+#include "Exceptions.h"
+
+// Политики консольной игры для BasicGame
+
+// Случайные числа из rand(): последовательность та же, что и без политик, поэтому --seed воспроизводит партию
+struct StdRng {
+    int operator()(int bound) {
+        return rand() % bound;
+    }
+};
+
+// Бот консольной игры; сложность меняется во время игры.
+// Easy стреляет наугад, Normal - по карте вероятностей EnemyAI, Hard - поиском MctsAI
+class ConsoleEnemy {
+private:
+    EnemyAI enemyAI;
+    MctsAI mctsAI;
+    Difficulty difficulty = Difficulty::Normal;
+
+    template <typename Engine>
+    void plannedTurn(Engine& game) {
+        // Бот решает, выгоднее ли применить способность из начала очереди, чем просто стрелять
+        if (!game.getEnemyAbilitiesManager().getQueue().empty()) {
+            AbilityDecision decision = enemyAI.planAbility(*game.getEnemyAbilitiesManager().getQueue().front(),
+                                                           game.getPlayerField(), game.getPlayerShipManager());
+            if (decision.use) {
+                std::unique_ptr<Ability> used = game.useAbility(false, decision.target);
+                std::cout << "Враг применяет способность " << used->getName()
+                          << " (" << decision.target.x << ", " << decision.target.y << ")\n";
+                enemyAI.observeAbility(*used, decision.target, game.getPlayerField());
+            }
+        }
+
+        Coords target = enemyAI.chooseShot(game.getPlayerField(), game.getPlayerShipManager());
+        shoot(game, target);
+    }
+
+    template <typename Engine>
+    void searchTurn(Engine& game) {
+        MctsMove move = mctsAI.search(game.getPlayerField(), game.getPlayerShipManager(), enemyAI.getScanned(),
+                                      game.getEnemyAbilitiesManager().getQueueKinds(), true);
+        if (move.iterations == 0) {
+            plannedTurn(game); // поиск не успел или не смог построить расстановку - ходим по карте вероятностей
+            return;
+        }
+        if (move.use_ability) {
+            std::unique_ptr<Ability> used = game.useAbility(false, move.target);
+            std::cout << "Враг применяет способность " << used->getName()
+                      << " (" << move.target.x << ", " << move.target.y << ")\n";
+            enemyAI.observeAbility(*used, move.target, game.getPlayerField());
+            if (game.getPlayerShipManager().getAliveShipsNumber() == 0) {
+                return;
+            }
+            // После способности ход продолжается выстрелом, его выбираем отдельным поиском
+            move = mctsAI.search(game.getPlayerField(), game.getPlayerShipManager(), enemyAI.getScanned(),
+                                 game.getEnemyAbilitiesManager().getQueueKinds(), false);
+        }
+        shoot(game, move.target);
+    }
+
+    template <typename Engine>
+    static void shoot(Engine& game, Coords target) {
+        std::cout << "Атака врага (" << target.x << ", " << target.y << ")\n";
+        if (game.tryAttack(false, target).result == AttackResult::OutOfBounds) {
+            std::cerr << "Enemy attack failed: " << OutOfFieldAttackException().what() << "\n";
+        }
+    }
+
+public:
+    // Консольный бот играет только за свою сторону, by_player всегда false
+    template <typename Engine>
+    void turn(Engine& game, bool) {
+        if (difficulty == Difficulty::Easy) {
+            int x = game.random(game.getPlayerField().getWidth());
+            int y = game.random(game.getPlayerField().getHeight());
+            shoot(game, {x, y}); // случайная клетка всегда в пределах поля
+        } else if (difficulty == Difficulty::Normal) {
+            plannedTurn(game);
+        } else {
+            searchTurn(game);
+        }
+    }
+
+    void reset() { enemyAI.reset(); } // знания бота относятся к старому полю игрока
+    void setDifficulty(Difficulty new_difficulty) { difficulty = new_difficulty; }
+    Difficulty getDifficulty() const { return difficulty; }
+    MctsAI& getMctsAI() { return mctsAI; }
+};
+
+// Вывод консольной игры: кадр полей (целиком или ANSI-разницей) и события ходов в отчет сценария
+class ConsoleRenderer {
+private:
+    BoardRenderer renderer;        // буфер кадра переиспользуется между ходами
+    AnsiDiffRenderer diffRenderer; // в режиме ANSI выводятся только изменившиеся клетки
+    bool ansiRendering = false;
+    std::shared_ptr<PlayerInput> results; // куда сообщать о выстрелах и способностях, может быть пустым
+
+public:
+    void setAnsiRendering(bool enabled);
+    bool getAnsiRendering() const;
+    void setResults(std::shared_ptr<PlayerInput> new_results);
+
+    void shot(bool by_player, Coords target, AttackOutcome outcome);
+    void ability(bool by_player, const Ability& used, Coords target);
+    void frame(const GameField& player, const GameField& enemy, const AbilityManager& abilities);
+};
@@ -6,4 +6,5 @@ class DoubleDamage : public Ability {
 public:
     void apply(GameField& field, ShipManager& manager, Coords coords) override;
     std::string getName() const override;
+    AbilityKind getKind() const override;
 };
\ No newline at end of file
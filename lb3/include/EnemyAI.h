@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "GameField.h"
+#include "ShipManager.h"
+#include "Ability.h"
+#include "ProbabilityMap.h"
+
+enum class Difficulty { Easy, Normal, Hard };
+
+struct AbilityDecision {
+    bool use = false;
+    Coords target {0, 0};
+    double value = 0.0;      // ожидаемый урон (в единицах здоровья) или информация (в битах)
+    double shot_value = 0.0; // то же для обычного выстрела, с которым сравнивается способность
+};
+
+// Бот, выбирающий выстрелы и применение способностей по карте вероятностей.
+// Способность из начала очереди применяется, если её ожидаемый урон или
+// количество информации больше, чем у лучшего обычного выстрела.
+class EnemyAI {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<std::int8_t> scanned; // результаты сканера: 1 - корабль, -1 - пусто, 0 - неизвестно
+
+    void fitTo(const GameField& field);
+    double bestShotDamage(const GameField& field, const ProbabilityMap& map, Coords& best) const;
+
+public:
+    void reset();
+
+    static std::vector<int> remainingLengths(ShipManager& manager);
+    static bool isTarget(const GameField& field, Coords coords);
+    static double entropy(double p);
+    // Ключ наблюдаемого ботом состояния для кэшей: поле, потопленные корабли, сканер и оставшийся флот
+    static std::uint64_t observationKey(const GameField& field, ShipManager& manager,
+                                        const std::vector<std::int8_t>& scanned);
+
+    ProbabilityMap buildMap(const GameField& field, ShipManager& manager);
+    AbilityDecision planAbility(const Ability& ability, const GameField& field, ShipManager& manager);
+    Coords chooseShot(const GameField& field, ShipManager& manager);
+    void observeAbility(const Ability& ability, Coords target, const GameField& field);
+    const std::vector<std::int8_t>& getScanned() const;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
 
 class ShipPlacementException : public std::runtime_error {
 public:
@@ -10,4 +11,15 @@ public:
 class OutOfFieldAttackException : public std::runtime_error {
 public:
     OutOfFieldAttackException() : std::runtime_error("Attack out of field bounds.") {}
-};
\ No newline at end of file
+};
+class ScriptFinishedException : public std::runtime_error {
+public:
+    ScriptFinishedException() : std::runtime_error("Input script is finished.") {}
+};
+
+// Сценарий не разбирается или требует не того действия, которое ждет игра
+class ScriptErrorException : public std::runtime_error {
+public:
+    ScriptErrorException(int line, const std::string& message)
+        : std::runtime_error("Script line " + std::to_string(line) + ": " + message) {}
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "GameField.h"
+
+// Сжатие плоскости клеток поля для сохранений.
+// Поток токенов по клеткам в построчном порядке:
+//   1SSKKKKK - серия из K + 1 клеток статуса SS (K < 31); при K = 31 далее varint, длина 32 + varint;
+//   0NNNNNNN - N + 1 клеток подряд, упакованных по 2 бита (младшие биты - первая клетка).
+// Серии короче minimalRun идут в упакованные блоки, поэтому и пустое, и пестрое поле
+// занимают мало места: 25x25 неизвестных клеток - 3 байта, случайное поле - около 170.
+// В JSON поток записывается строкой base64.
+class FieldCodec {
+public:
+    static constexpr int minimalRun = 4;
+
+    // Дописывает поток в конец out
+    static void encode(const Status* cells, std::size_t count, std::vector<std::uint8_t>& out);
+    // Восстанавливает ровно count клеток; возвращает число прочитанных байт
+    static std::size_t decode(const std::uint8_t* data, std::size_t size, Status* cells, std::size_t count);
+
+    static void encodeText(const Status* cells, std::size_t count, std::string& out);
+    static void decodeText(const std::string& text, Status* cells, std::size_t count);
+};
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
+#include <cstdint>
 #include "json.hpp"
 
 class FileHandler {
@@ -14,8 +16,14 @@ public:
     FileHandler(const std::string& file_name);
     void openForRead();
     void openForWrite();
+    void openForAppend();
     void write(const nlohmann::json& info);
     void read(nlohmann::json& info);
+    void writeText(const std::string& text);
+    void writeBytes(const std::vector<std::uint8_t>& data);
+    void readBytes(std::vector<std::uint8_t>& data);
+    // Запись во временный файл, fsync и переименование: файл либо старый, либо новый целиком
+    void writeDurable(const char* data, std::size_t size);
     void closeRead();
     void closeWrite();
     ~FileHandler();
@@ -1,61 +1,55 @@
 #pragma once
 
-#include "GameField.h"
-#include "ShipManager.h"
-#include "AbilityManager.h"
+#include "GameEngine.h"
+#include "ConsolePolicies.h"
+#include "SaveImage.h"
+#include "JsonSaveWriter.h"
+#include "SaveJournal.h"
+#include "AsyncSaver.h"
+#include "PlayerInput.h"
 
 using namespace std;
 
-class Game {
-private:
-    GameField playerField;
-    GameField enemyField;
-    ShipManager playerShipManager;
-    ShipManager enemyShipManager;
-    AbilityManager playerAbilitiesManager;
+// Правила консольной игры: rand(), бот выбранной сложности, вывод в консоль, журнал ходов
+using ConsoleEngine = BasicGame<StdRng, ConsoleEnemy, ConsoleRenderer, SaveJournal>;
 
-    int roundCounter = 0;
-    bool isPlayerStep = true;
-    bool isPlayerUseAbility = false;
-    bool isPlayerDoAttack = false;
+class Game : public ConsoleEngine {
+private:
+    SaveFormat saveFormat = SaveFormat::Auto;
+    JsonSaveWriter saveWriter; // буфер JSON переиспользуется между сохранениями
+    shared_ptr<PlayerInput> input = make_shared<ConsoleInput>(); // откуда берутся решения игрока
+    string autosaveFile;       // сохранение после каждого хода, пусто - выключено
+
+    struct PendingSave {
+        string file_name;
+        shared_future<bool> saved;
+        bool report;           // сообщать об успехе (ручное сохранение) или только об ошибке (автосохранение)
+    };
+    deque<PendingSave> pendingSaves; // фоновые сохранения, о которых еще не сообщили
 
     void initializeGame();
     void print_fields();
     void resetEnemy();
     void playerTurn(int& enemyShipCount);
-    void enemyTurn(int& playerShipCount);
     bool playRound();
 
 public:
-    Game();
-    // Измененный конструктор для перемещения
-    Game(GameField playerField, GameField enemyField,
-         ShipManager playerShipManager, ShipManager enemyShipManager,
-         AbilityManager playerAbilitiesManager, int roundCounter,
-         bool isPlayerStep, bool isPlayerUseAbility, bool isPlayerDoAttack)
-        : playerField(std::move(playerField)),
-          enemyField(std::move(enemyField)),
-          playerShipManager(std::move(playerShipManager)),
-          enemyShipManager(std::move(enemyShipManager)),
-          playerAbilitiesManager(std::move(playerAbilitiesManager)),
-          roundCounter(roundCounter),
-          isPlayerStep(isPlayerStep),
-          isPlayerUseAbility(isPlayerUseAbility),
-          isPlayerDoAttack(isPlayerDoAttack) {}
+    // Конструктор по умолчанию и конструктор из готовых полей, кораблей и способностей
+    using ConsoleEngine::ConsoleEngine;
 
     void startGame(int loaded);
+    void setDifficulty(Difficulty new_difficulty) { enemy.setDifficulty(new_difficulty); }
+    Difficulty getDifficulty() const { return enemy.getDifficulty(); }
+    MctsAI& getMctsAI() { return enemy.getMctsAI(); }
+    void setSaveFormat(SaveFormat new_format) { saveFormat = new_format; }
+    SaveFormat getSaveFormat() const { return saveFormat; }
+    bool writeSave(const string& file_name);
     void saveGame(const string& file_name);
+    void queueSave(const string& file_name, bool report);
+    void reportSaves(bool wait);
+    void setAutosaveFile(const string& file_name) { autosaveFile = file_name; }
+    void setAnsiRendering(bool enabled) { view.setAnsiRendering(enabled); }
+    void setInput(shared_ptr<PlayerInput> new_input);
+    PlayerInput& getInput() { return *input; }
     bool loadGame(const string& file_name);
-
-    // Методы для получения текущего состояния
-    int getRoundCounter() const { return roundCounter; }
-    bool getIsPlayerStep() const { return isPlayerStep; }
-    bool getIsPlayerUseAbility() const { return isPlayerUseAbility; }
-    bool getIsPlayerDoAttack() const { return isPlayerDoAttack; }
-
-    GameField& getPlayerField() { return playerField; }
-    GameField& getEnemyField() { return enemyField; }
-    ShipManager& getPlayerShipManager() { return playerShipManager; }
-    ShipManager& getEnemyShipManager() { return enemyShipManager; }
-    AbilityManager& getPlayerAbilitiesManager() { return playerAbilitiesManager; }
 };
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <stdexcept>
+#include "GameField.h"
+#include "ShipManager.h"
+#include "AbilityManager.h"
+#include "Exceptions.h"
+#include "Zobrist.h"
+
+// Правила партии, параметризованные политиками:
+//   Rng         - int operator()(int bound): равномерное число из [0, bound); через него идут расстановка,
+//                 выдача способностей и цель Bombardment, а rand() остается только у AbilityManager() и
+//                 Bombardment, примененных в обход BasicGame
+//   Enemy       - template <typename Engine> void turn(Engine& game, bool by_player): ход стороны by_player
+//   Renderer    - shot(by_player, target, outcome), ability(by_player, ability, target),
+//                 frame(player_field, enemy_field, player_abilities)
+//   Persistence - recordShot, recordAbility, recordFailedAbility (noexcept), recordGrant, как у SaveJournal
+// Консольная игра (Game) и безголовая симуляция (SimulationGame) выполняют один и тот же код правил.
+// Вызовы политик разрешаются при компиляции, у пустых политик они исчезают целиком.
+template <typename Rng, typename Enemy, typename Renderer, typename Persistence>
+class BasicGame {
+protected:
+    GameField playerField;
+    GameField enemyField;
+    ShipManager playerShipManager;
+    ShipManager enemyShipManager;
+    AbilityManager playerAbilitiesManager;
+    AbilityManager enemyAbilitiesManager;
+    Rng rng;
+    Enemy enemy;
+    Renderer view;
+    Persistence persistence; // действия, меняющие состояние, попадают сюда
+
+    int roundCounter = 0;
+    bool isPlayerStep = true;
+    bool isPlayerUseAbility = false;
+    bool isPlayerDoAttack = false;
+
+public:
+    // Каждой стороне одна случайная способность, как в AbilityManager(), но из rng и без записи в журнал
+    BasicGame()
+        : playerField(classicFieldSize, classicFieldSize), enemyField(classicFieldSize, classicFieldSize),
+          playerShipManager({2, 1}), enemyShipManager({2, 1}),
+          playerAbilitiesManager(std::deque<std::unique_ptr<Ability>>()),
+          enemyAbilitiesManager(std::deque<std::unique_ptr<Ability>>()) {
+        playerAbilitiesManager.addAbility(AbilityManager::createAbility(randomAbilityKind()));
+        enemyAbilitiesManager.addAbility(AbilityManager::createAbility(randomAbilityKind()));
+    }
+
+    BasicGame(GameField playerField, GameField enemyField,
+              ShipManager playerShipManager, ShipManager enemyShipManager,
+              AbilityManager playerAbilitiesManager, AbilityManager enemyAbilitiesManager, int roundCounter,
+              bool isPlayerStep, bool isPlayerUseAbility, bool isPlayerDoAttack)
+        : playerField(std::move(playerField)),
+          enemyField(std::move(enemyField)),
+          playerShipManager(std::move(playerShipManager)),
+          enemyShipManager(std::move(enemyShipManager)),
+          playerAbilitiesManager(std::move(playerAbilitiesManager)),
+          enemyAbilitiesManager(std::move(enemyAbilitiesManager)),
+          roundCounter(roundCounter),
+          isPlayerStep(isPlayerStep),
+          isPlayerUseAbility(isPlayerUseAbility),
+          isPlayerDoAttack(isPlayerDoAttack) {}
+
+    AttackOutcome tryAttack(bool by_player, Coords target) {
+        AttackOutcome outcome = (by_player ? enemyField : playerField).tryAttack(target);
+        if (outcome.result != AttackResult::OutOfBounds) {
+            persistence.recordShot(by_player, target);
+        }
+        view.shot(by_player, target, outcome);
+        return outcome;
+    }
+
+    void attack(bool by_player, Coords target) { // бросает OutOfFieldAttackException
+        if (tryAttack(by_player, target).result == AttackResult::OutOfBounds) {
+            throw OutOfFieldAttackException();
+        }
+    }
+
+    std::unique_ptr<Ability> useAbility(bool by_player, Coords target) {
+        AbilityManager& abilities = by_player ? playerAbilitiesManager : enemyAbilitiesManager;
+        if (abilities.getQueue().empty()) {
+            throw NoAvailableAbilitiesException();
+        }
+        AbilityKind kind = abilities.getQueue().front()->getKind();
+        if (kind == AbilityKind::Bombardment) {
+            // сегмент для удара выбирает rng, а не rand() внутри Bombardment
+            ShipManager& ships = by_player ? enemyShipManager : playerShipManager;
+            if (ships.getLiveSegmentCount() > 0) {
+                Ship::ShipSegment* segment = ships.getLiveSegment(rng(ships.getLiveSegmentCount()));
+                dynamic_cast<Bombardment&>(*abilities.getQueue().front()).presetTarget(segment->coords);
+            }
+        }
+        std::unique_ptr<Ability> used;
+        try {
+            used = by_player ? abilities.applyAbility(enemyField, enemyShipManager, target)
+                             : abilities.applyAbility(playerField, playerShipManager, target);
+        } catch (const std::exception&) {
+            // способность уже снята с очереди, даже если цель оказалась неверной.
+            // recordFailedAbility не бросает, поэтому вызывающий получает исходное исключение
+            persistence.recordFailedAbility(by_player, kind, target);
+            throw;
+        }
+        persistence.recordAbility(by_player, *used, target);
+        view.ability(by_player, *used, target);
+        return used;
+    }
+
+    void grantAbility(bool by_player) {
+        AbilityKind kind = randomAbilityKind();
+        (by_player ? playerAbilitiesManager : enemyAbilitiesManager).addAbility(AbilityManager::createAbility(kind));
+        persistence.recordGrant(by_player, kind);
+    }
+
+    // Способность за каждый корабль противника, потопленный с прошлого подсчета; false - новых нет
+    bool rewardSunk(bool by_player, int& opponent_ship_count) {
+        int alive = (by_player ? enemyShipManager : playerShipManager).getAliveShipsNumber();
+        if (opponent_ship_count <= alive) {
+            return false;
+        }
+        for (int i = alive; i < opponent_ship_count; ++i) {
+            grantAbility(by_player);
+        }
+        opponent_ship_count = alive;
+        return true;
+    }
+
+    // Оба поля и способности игрока одним кадром
+    void render() {
+        view.frame(playerField, enemyField, playerAbilitiesManager);
+    }
+
+    int random(int bound) {
+        return rng(bound);
+    }
+
+    void enemyTurn(int& playerShipCount) {
+        isPlayerStep = false;
+        enemy.turn(*this, false);
+        rewardSunk(false, playerShipCount);
+        // Передача хода обратно игроку
+        isPlayerStep = true;
+        isPlayerDoAttack = false;
+    }
+
+    // Партия без человека: за игрока ходит player_side (политика того же вида, что Enemy).
+    // true - флот бота потоплен первым; false - первым потоплен флот игрока или за limit раундов
+    // никто не победил
+    template <typename Side>
+    bool playAutomatic(Side& player_side, int limit) {
+        int playerShipCount = playerShipManager.getAliveShipsNumber();
+        int enemyShipCount = enemyShipManager.getAliveShipsNumber();
+        for (int round = 0; round < limit; ++round) {
+            ++roundCounter;
+            isPlayerStep = true;
+            player_side.turn(*this, true);
+            rewardSunk(true, enemyShipCount);
+            if (enemyShipCount == 0) {
+                return true;
+            }
+            enemyTurn(playerShipCount);
+            if (playerShipCount == 0) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Новые поля width x height и случайная расстановка флотов ship_sizes; у каждой стороны
+    // одна случайная способность, как в начале консольной игры. Поля больше maximalFieldSize
+    // создаются в режиме FieldMode::Large
+    void arrangeRandomly(int width, int height, const std::vector<int>& ship_sizes) {
+        FieldMode mode = width > maximalFieldSize || height > maximalFieldSize ? FieldMode::Large : FieldMode::Classic;
+        arrangeRandomly(width, height, ship_sizes, mode);
+    }
+
+    void arrangeRandomly(int width, int height, const std::vector<int>& ship_sizes, FieldMode mode) {
+        playerField = GameField(width, height, mode);
+        enemyField = GameField(width, height, mode);
+        playerShipManager = ShipManager(ship_sizes);
+        enemyShipManager = ShipManager(ship_sizes);
+        playerAbilitiesManager = AbilityManager(std::deque<std::unique_ptr<Ability>>());
+        enemyAbilitiesManager = AbilityManager(std::deque<std::unique_ptr<Ability>>());
+        arrangeFleet(playerField, playerShipManager);
+        arrangeFleet(enemyField, enemyShipManager);
+        grantAbility(true);
+        grantAbility(false);
+        roundCounter = 0;
+        isPlayerStep = true;
+        isPlayerUseAbility = false;
+        isPlayerDoAttack = false;
+    }
+
+    // Хеш наблюдаемого состояния: выстрелы, попадания, потопленные корабли, очереди способностей и чей ход.
+    // Все слагаемые поддерживаются инкрементально, поэтому сборка хеша не обходит поля.
+    std::uint64_t getStateHash() const {
+        std::uint64_t hash = playerField.getHash();
+        hash ^= Zobrist::rotate(enemyField.getHash(), 11);
+        hash ^= Zobrist::rotate(playerShipManager.getHash(), 23);
+        hash ^= Zobrist::rotate(enemyShipManager.getHash(), 37);
+        hash ^= Zobrist::rotate(playerAbilitiesManager.getHash(), 43);
+        hash ^= Zobrist::rotate(enemyAbilitiesManager.getHash(), 53);
+        if (!isPlayerStep) {
+            hash ^= Zobrist::sideToMove();
+        }
+        return hash;
+    }
+
+    void restoreTurnState(int round, bool player_step, bool use_ability, bool do_attack) {
+        roundCounter = round;
+        isPlayerStep = player_step;
+        isPlayerUseAbility = use_ability;
+        isPlayerDoAttack = do_attack;
+    }
+
+    int getRoundCounter() const { return roundCounter; }
+    bool getIsPlayerStep() const { return isPlayerStep; }
+    bool getIsPlayerUseAbility() const { return isPlayerUseAbility; }
+    bool getIsPlayerDoAttack() const { return isPlayerDoAttack; }
+
+    GameField& getPlayerField() { return playerField; }
+    GameField& getEnemyField() { return enemyField; }
+    ShipManager& getPlayerShipManager() { return playerShipManager; }
+    ShipManager& getEnemyShipManager() { return enemyShipManager; }
+    AbilityManager& getPlayerAbilitiesManager() { return playerAbilitiesManager; }
+    AbilityManager& getEnemyAbilitiesManager() { return enemyAbilitiesManager; }
+    Rng& getRng() { return rng; }
+    Enemy& getEnemy() { return enemy; }
+    Renderer& getView() { return view; }
+    Persistence& getPersistence() { return persistence; }
+
+private:
+    static constexpr int arrangeAttempts = 1000; // попыток на корабль
+
+    AbilityKind randomAbilityKind() {
+        return static_cast<AbilityKind>(rng(abilityKindCount));
+    }
+
+    void arrangeFleet(GameField& field, ShipManager& manager) {
+        while (manager.getFreeShipCount() > 0) {
+            Ship& ship = manager.getFreeShip(0);
+            bool placed = false;
+            for (int attempt = 0; attempt < arrangeAttempts && !placed; ++attempt) {
+                Orientation orientation = rng(2) ? Orientation::Vertical : Orientation::Horizontal;
+                Coords top_left {rng(field.getWidth()), rng(field.getHeight())};
+                if (field.shipCoordinatesCorrect(top_left, orientation, ship.getLength())) {
+                    field.placeShip(ship, top_left, orientation);
+                    placed = true;
+                }
+            }
+            if (!placed) {
+                throw std::runtime_error("Can't arrange the fleet on the field");
+            }
+            manager.moveShipToActive(0);
+        }
+    }
+};
@@ -1,32 +1,80 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include "Ship.h"
+#include "Neighborhood.h"
+#include "SparseCellTable.h"
+#include "ShipSpatialIndex.h"
 
 constexpr int minimalFieldSize = 3;
 constexpr int maximalFieldSize = 25;
+constexpr int classicFieldSize = 10; // поле классической партии
+constexpr int maximalLargeFieldSize = 4096; // поле в режиме FieldMode::Large
+static_assert(maximalFieldSize <= neighborhoodSide, "neighborhood tables must cover the largest field");
 
-enum class Status { Unknown, Empty, Ship };
+enum class Status : std::uint8_t { Unknown, Empty, Ship };
+
+// Classic - до maximalFieldSize, все клетки в памяти, соседства по таблицам Neighborhood.
+// Large - до maximalLargeFieldSize, память выделяется блоками только там, где были корабли и выстрелы.
+// Sparse - до maximalLargeFieldSize, хранятся только клетки кораблей и выстрелов (SparseCellTable):
+// память растет с числом действий, а не с площадью, для огромных почти пустых карт.
+// Сохранения, кэши ботов и MctsAI работают только с классическими полями.
+enum class FieldMode { Classic, Large, Sparse };
+
+// Исход выстрела без исключений. AlreadyShot - промах по уже открытой пустой клетке
+// или выстрел по уничтоженному сегменту: состояние не меняется.
+enum class AttackResult { OutOfBounds, Miss, Hit, Sunk, AlreadyShot };
+
+struct AttackOutcome {
+    AttackResult result = AttackResult::OutOfBounds;
+    int ship_id = -1; // корабль в клетке (Ship::getId), -1 - корабля нет
+};
 
 struct Cell {
+    Ship::ShipSegment* ship_segment_pointer = nullptr;
     bool ship_is_here = false;
-    bool ship_is_nearly = false;
     Status status_cell { Status::Unknown };
-    Ship::ShipSegment* ship_segment_pointer = nullptr;
     bool missed = false; // для промахов чтобы печатать x вместо o
 };
 
 class GameField {
 private:
+    // Клетки хранятся блоками chunkSide x chunkSide, построчно внутри блока; крайние блоки обрезаны по полю
+    static constexpr int chunkShift = 5;
+    static constexpr int chunkSide = 1 << chunkShift;
+
+    struct Chunk {
+        int width = 0;
+        std::vector<Cell> cells;
+    };
+
     int height;
     int width;
-    std::vector<std::vector<Cell>> field; // матрица поля из информации о клетке
+    FieldMode mode = FieldMode::Classic;
+    int chunk_columns = 0;
+    std::vector<std::unique_ptr<Chunk>> chunks; // пустой указатель - в блоке не было ни кораблей, ни выстрелов
+    SparseCellTable<Cell> sparse; // клетки поля Sparse
+    ShipSpatialIndex ship_index;  // расставленные корабли по корзинам сетки
+    std::uint64_t zobrist = 0; // хеш Зобриста статусов клеток, обновляется при каждом изменении статуса
+    Bitboard ships;    // клетки кораблей (только Classic)
+    Bitboard occupied; // клетки кораблей и их ореолы: сюда нельзя ставить новый корабль (только Classic)
+
+    void allocate(int new_width, int new_height, FieldMode new_mode);
+    void copyCells(const GameField& other);
+    Cell& cellAt(Coords coords); // создает блок (запись Sparse) при необходимости
+    const Cell& peekCell(Coords coords) const noexcept; // без создания; координаты в пределах поля
+    void changeStatus(Cell& cell, Coords coords, Status new_status);
+    bool shipFits(Coords top_left, Orientation orientation, int size, bool with_halo) const;
+    void putShip(Ship& ship, Coords top_left, Orientation orientation);
 
 public:
     GameField();
     GameField(int new_width, int new_height);
+    GameField(int new_width, int new_height, FieldMode new_mode);
     GameField(const GameField& other);
     GameField(GameField&& other) noexcept;
 
@@ -35,17 +83,24 @@ public:
 
     Cell& getCellAt(const Coords& coords);
     const Cell& getCellAt(const Coords& coords) const;
-    std::vector<std::vector<Cell>>& getField();
     int getWidth() const;
     int getHeight() const;
+    FieldMode getMode() const;
+    std::size_t getStorageBytes() const; // память под клетки, без самого объекта поля
+    const ShipSpatialIndex& getShipIndex() const;
     bool coordinatsInField(Coords coords_check) const;
     bool shipCoordinatesCorrect(Coords top_left, Orientation orientation, int size);
     void resizeSize(int width, int height);
     void placeShip(Ship& ship, Coords top_left, Orientation orientation);
+    // Корабль из сохранения: проверяются только границы, касание с соседями допускается
+    void placeRestoredShip(Ship& ship, Coords top_left, Orientation orientation);
     void attackCell(Coords attack_coords);
+    AttackOutcome tryAttack(Coords attack_coords) noexcept;
+    const Cell* findCell(Coords coords) const noexcept; // nullptr вне поля
     void print_field() const;
     Status getCellStatus(const Coords& coords) const;
     void setCellStatus(const Coords& coords, Status new_status);
     bool isShipHereDestroyed(const Coords& coords);
     bool isShipHere(const Coords& coords);
+    std::uint64_t getHash() const;
 };
\ No newline at end of file
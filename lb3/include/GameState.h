@@ -5,6 +5,7 @@
 #include "Game.h"
 #include "FileHandler.h"
 #include "Exceptions.h"
+#include "SaveImage.h"
 #include "json.hpp"
 #include <stdexcept>
 using namespace std;
@@ -14,10 +15,17 @@ using json = nlohmann::json;
 class GameState {
 private:
     json current_state;
+    SaveFormat format = SaveFormat::Json;
+    SaveImage image; // состояние, прочитанное из файла или снятое для двоичного сохранения
+    bool has_image = false;
+    string text;     // JSON-текст состояния, если он уже записан
+
+    const string& jsonText();
+    json& tree();
 
 public:
     GameState(const string& file_name);
-    GameState(Game& game);
+    GameState(Game& game, SaveFormat format = SaveFormat::Json);
     ~GameState() = default;
 
     json saveFieldToJson(const GameField& field);
@@ -25,6 +33,13 @@ public:
     json saveAbilityManagerToJson(const AbilityManager& ability_manager);
 
     bool save(const string& file_name);
+    static bool saveText(const string& file_name, const string& json_text);
+    static SaveFormat formatForFile(const string& file_name);
+    SaveFormat getFormat() const { return format; }
+
+    static void readFieldImage(int width, int height, json& field_data, SaveImage::SideImage& side);
+    static void readShipsImage(json& ship_data, SaveImage::SideImage& side);
+    static void readAbilitiesImage(json& ability_data, SaveImage::SideImage& side);
 
     GameField loadFieldFromJson(int width, int height, json& field_data);
     ShipManager loadShipManagerFromJson(json& ship_data, GameField& field);
@@ -35,12 +50,13 @@ public:
     friend ostream& operator<<(ostream& os, GameState& state);
     friend istream& operator>>(istream& is, GameState& state);
 
-    // Getter methods for JSON data
-    const json& getCurrentState() const { return current_state; }
-    json& getPlayerFieldData() { return current_state["player_field"]; }
-    json& getEnemyFieldData() { return current_state["bot_field"]; }
-    json& getPlayerShipData() { return current_state["player_ship_data"]; }
-    json& getEnemyShipData() { return current_state["bot_ship_data"]; }
-    json& getAbilityManagerData() { return current_state["player_ability_manager"]; }
+    // Getter methods for JSON data (дерево строится при первом обращении)
+    const json& getCurrentState() { return tree(); }
+    json& getPlayerFieldData() { return tree()["player_field"]; }
+    json& getEnemyFieldData() { return tree()["bot_field"]; }
+    json& getPlayerShipData() { return tree()["player_ship_data"]; }
+    json& getEnemyShipData() { return tree()["bot_ship_data"]; }
+    json& getAbilityManagerData() { return tree()["player_ability_manager"]; }
+    json& getEnemyAbilityManagerData() { return tree()["bot_ability_manager"]; }
 
 };
\ No newline at end of file
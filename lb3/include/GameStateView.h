@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "SaveImage.h"
+#include "Game.h"
+
+// Ленивое чтение сохранения: файл читается в память один раз, а части разбираются
+// при первом обращении и запоминаются. Заголовок JSON-сохранения (раунд, флаги хода)
+// читается без разбора полей и флотов, сторона - без разбора другой стороны.
+// Двоичное сохранение разбирается целиком при первом обращении к стороне, журнал - сразу.
+class GameStateView {
+private:
+    std::vector<std::uint8_t> data;
+    SaveFormat format = SaveFormat::Json;
+    SaveImage image;
+    bool has_header = false;
+    unsigned sides = 0; // какие стороны уже разобраны (SaveSaxLoader::Section)
+
+    void loadHeader();
+    void loadSides(unsigned wanted);
+
+public:
+    explicit GameStateView(const std::string& file_name);
+
+    SaveFormat getFormat() const { return format; }
+    int getRoundCounter();
+    bool getIsPlayerStep();
+    bool getIsPlayerUseAbility();
+    bool getIsPlayerDoAttack();
+
+    const SaveImage::SideImage& getPlayerSide();
+    const SaveImage::SideImage& getBotSide();
+    int getAliveShips(bool player_side);
+
+    Game load();
+};
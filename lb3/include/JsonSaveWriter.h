@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "SaveImage.h"
+
+class Game;
+
+// Запись JSON-сохранения сразу в текст, без построения дерева json.
+// Схема та же, что у GameState; ключи заголовка (раунд, флаги, размеры полей) идут первыми.
+// Буфер переиспользуется между вызовами, поэтому автосохранение каждый ход не выделяет память.
+// Поля записываются строкой FieldCodec (base64), а не вложенными массивами.
+// В режиме pretty отступы такие же, как у json::dump(4).
+class JsonSaveWriter {
+private:
+    std::string buffer;
+    bool pretty;
+    std::vector<bool> first; // для каждого открытого контейнера: еще не было элементов
+    std::vector<Status> cells; // клетки поля подряд перед упаковкой
+
+    void newline();
+    void separator();
+    void open(char bracket);
+    void close(char bracket);
+    void key(const char* name);
+    void value(int number);
+    void value(bool flag);
+    void value(const char* text);
+
+    void field(const Status* cells, int count);
+    void header(int round, bool player_step, bool use_ability, bool do_attack,
+                int player_width, int player_height, int bot_width, int bot_height);
+    void ships(const ShipManager& manager);
+    void ships(const std::vector<SaveImage::ShipImage>& ships);
+    void abilities(const std::vector<AbilityKind>& kinds);
+    void abilities(const AbilityManager& manager);
+
+public:
+    explicit JsonSaveWriter(bool pretty = true);
+
+    void setPretty(bool new_pretty);
+    const std::string& write(Game& game);
+    const std::string& write(const SaveImage& image);
+    const std::string& getBuffer() const;
+    std::string release(); // забрать текст, буфер после этого пуст
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Ship.h"
+
+// Индекс живых (не уничтоженных) сегментов флота.
+// Добавление, удаление и равновероятный выбор сегмента выполняются за O(1):
+// удаление меняет сегмент местами с последним, а сегмент хранит свою позицию в live_slot.
+// Индекс получает каждое изменение сегментов флота и заодно ведет хеш Зобриста
+// их состояний и потопленных кораблей, а также число потопленных кораблей.
+class LiveSegmentIndex {
+private:
+    std::vector<Ship::ShipSegment*> segments;
+    std::uint64_t hash = 0;
+    int sunk = 0; // потопленные корабли флота
+
+public:
+    void add(Ship::ShipSegment* segment);
+    void remove(Ship::ShipSegment* segment);
+    Ship::ShipSegment* get(int slot) const; // slot из [0, size())
+    Ship::ShipSegment* getRandom() const;   // выбор через rand()
+    int size() const;
+    bool empty() const;
+
+    void segmentChanged(Ship::ShipSegment* segment, SegmentStatus old_status);
+    void shipSunk(const Ship& ship);
+    int getSunkCount() const;
+    std::uint64_t getHash() const;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include "GameField.h"
+#include "ShipManager.h"
+#include "Ability.h"
+#include "TranspositionTable.h"
+
+struct MctsMove {
+    bool use_ability = false; // применить способность из начала очереди (ход после этого продолжается выстрелом)
+    Coords target {0, 0};     // цель способности или выстрела
+    int iterations = 0;       // сколько симуляций успели выполнить все потоки
+};
+
+// Запись кэша результатов поиска: лучшее действие в корне и сколько симуляций его подтвердили
+struct MctsCacheEntry {
+    std::int32_t action;
+    std::int32_t iterations;
+};
+
+struct MctsNode {
+    int action = -1;
+    int parent = -1;
+    int first_child = -1;
+    int next_sibling = -1;
+    int children = 0;
+    int visits = 0;
+    int availability = 0; // сколько раз действие было допустимо в выбранной детерминизации
+    double value = 0.0;
+};
+
+// Арена узлов дерева: память выделяется один раз, узел создается сдвигом счетчика.
+class NodePool {
+private:
+    std::vector<MctsNode> nodes;
+    int capacity;
+
+public:
+    explicit NodePool(int capacity);
+    int allocate();
+    bool full() const;
+    int size() const;
+    MctsNode& operator[](int index);
+    const MctsNode& operator[](int index) const;
+};
+
+// Симуляция хода бота в одной детерминизации: корабли игрока расставлены так,
+// чтобы не противоречить тому, что бот уже видел.
+struct MctsWorld {
+    enum Seen : std::uint8_t { Unknown, Closed, HitDamaged, HitDone, KnownShip };
+
+    int width = 0;
+    int height = 0;
+    std::vector<std::int8_t> ship;      // индекс корабля в клетке или -1
+    std::vector<std::int8_t> hp;        // здоровье сегмента в клетке
+    std::vector<std::uint8_t> seen;     // что бот знает о клетке
+    std::vector<std::vector<int>> ship_cells;
+    std::vector<int> ship_hp;
+    std::vector<AbilityKind> queue;
+    int queue_head = 0;
+    int alive_ships = 0;
+    int turns = 0;
+    bool ability_used = false;
+};
+
+// Поиск Монте-Карло по дереву для максимальной сложности.
+// Моделируется полный ход бота из Game::playRound: необязательная способность,
+// выстрел и случайная способность за каждый потопленный корабль. Скрытая расстановка
+// детерминизируется на каждой итерации (ISMCTS), поиск распараллелен по корню:
+// каждый поток строит свое дерево, результаты объединяются по числу посещений.
+// Поиск ограничен временем и может быть остановлен в любой момент.
+// Результаты поиска кэшируются по наблюдаемому состоянию в общей таблице транспозиций:
+// если такое же знание уже исследовано достаточным числом симуляций, поиск не повторяется.
+class MctsAI {
+private:
+    struct Root {
+        int width = 0;
+        int height = 0;
+        std::vector<std::uint8_t> seen;
+        std::vector<std::int8_t> known_hp;  // здоровье известных сегментов, -1 если неизвестно
+        std::vector<std::uint8_t> open;      // клетка может содержать живой корабль
+        std::vector<int> must_cover;         // известные клетки живых кораблей
+        std::vector<int> lengths;            // длины непотопленных кораблей
+        std::vector<AbilityKind> queue;
+        std::vector<double> prior;           // оценка действий в корне по карте вероятностей
+        int total_hp = 0;
+    };
+
+    int threads;
+    std::chrono::milliseconds budget;
+    int pool_capacity;
+
+    Root observe(const GameField& field, ShipManager& manager, const std::vector<std::int8_t>& scanned,
+                 const std::vector<AbilityKind>& queue, std::uint64_t observation_key) const;
+    bool determinize(const Root& root, MctsWorld& world, std::mt19937_64& rng) const;
+    void searchTree(const Root& root, bool ability_allowed, std::chrono::steady_clock::time_point deadline,
+                    std::uint64_t seed, std::vector<int>& root_visits, int& iterations) const;
+
+    static void legalActions(const MctsWorld& world, bool ability_phase, std::vector<int>& actions);
+    static int prior(const MctsWorld& world, int action);
+    static void applyAction(MctsWorld& world, int action, std::mt19937_64& rng);
+    static void shoot(MctsWorld& world, int cell, int damage, std::mt19937_64& rng);
+    static void useAbility(MctsWorld& world, int cell, std::mt19937_64& rng);
+    static bool isOpenTarget(const MctsWorld& world, int cell);
+    static void pushFocus(const MctsWorld& world, int cell, std::vector<int>& focus);
+    static double rollout(MctsWorld& world, const Root& root, std::mt19937_64& rng);
+
+public:
+    MctsAI(int threads = 0, std::chrono::milliseconds budget = std::chrono::milliseconds(40), int pool_capacity = 1 << 16);
+
+    void setBudget(std::chrono::milliseconds new_budget);
+    void setThreads(int new_threads);
+
+    MctsMove search(const GameField& field, ShipManager& manager, const std::vector<std::int8_t>& scanned,
+                    const std::vector<AbilityKind>& queue, bool ability_allowed) const;
+
+    static TranspositionTable<MctsCacheEntry>& sharedCache();
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Ship.h"
+
+// Сторона наибольшего поля, для которого посчитаны таблицы окрестностей
+constexpr int neighborhoodSide = 25;
+
+// Битовая доска: маска на строку, бит x - столбец x
+struct Bitboard {
+    std::uint32_t rows[neighborhoodSide] = {};
+
+    bool test(Coords coords) const {
+        return (rows[coords.y] >> coords.x) & 1u;
+    }
+
+    void set(Coords coords) {
+        rows[coords.y] |= 1u << coords.x;
+    }
+};
+
+// Клетки корабля и его прямоугольник с ореолом: одна маска столбцов на диапазон строк.
+// Строки и столбцы обрезаны по наибольшему полю, по размеру конкретного поля - при применении.
+struct ShipArea {
+    std::uint32_t ship_mask = 0;
+    std::uint32_t halo_mask = 0;
+    std::uint8_t ship_first = 0;
+    std::uint8_t ship_last = 0;
+    std::uint8_t halo_first = 0;
+    std::uint8_t halo_last = 0;
+};
+
+// Построение таблиц при компиляции
+class NeighborhoodTable {
+public:
+    static constexpr int areaCount = neighborhoodSide * neighborhoodSide * maximalShipLength * 2;
+
+    static constexpr std::uint32_t span(int first, int last) {
+        first = first < 0 ? 0 : first;
+        last = last >= neighborhoodSide ? neighborhoodSide - 1 : last;
+        return first > last ? 0 : ((~0u >> (31 - last)) & (~0u << first));
+    }
+
+    static constexpr std::uint8_t clampRow(int row) {
+        return static_cast<std::uint8_t>(row < 0 ? 0 : (row >= neighborhoodSide ? neighborhoodSide - 1 : row));
+    }
+
+    static constexpr int areaIndex(int x, int y, int length, bool vertical) {
+        return ((y * neighborhoodSide + x) * maximalShipLength + length - 1) * 2 + (vertical ? 1 : 0);
+    }
+
+    static constexpr std::array<ShipArea, areaCount> build() {
+        std::array<ShipArea, areaCount> areas {};
+        for (int y = 0; y < neighborhoodSide; ++y) {
+            for (int x = 0; x < neighborhoodSide; ++x) {
+                for (int length = minimalShipLength; length <= maximalShipLength; ++length) {
+                    for (int vertical = 0; vertical < 2; ++vertical) {
+                        int last_x = vertical ? x : x + length - 1;
+                        int last_y = vertical ? y + length - 1 : y;
+                        ShipArea& area = areas[areaIndex(x, y, length, vertical)];
+                        area.ship_mask = span(x, last_x);
+                        area.halo_mask = span(x - 1, last_x + 1);
+                        area.ship_first = clampRow(y);
+                        area.ship_last = clampRow(last_y);
+                        area.halo_first = clampRow(y - 1);
+                        area.halo_last = clampRow(last_y + 1);
+                    }
+                }
+            }
+        }
+        return areas;
+    }
+};
+
+// Окрестности клеток и кораблей, посчитанные при компиляции для каждой клетки,
+// длины и ориентации. Пометить ореол или проверить пересечение с ним - найти запись
+// в таблице и сделать OR (AND) по нескольким строкам доски, без проверки границ на соседа.
+class Neighborhood {
+private:
+    static constexpr std::array<ShipArea, NeighborhoodTable::areaCount> areas = NeighborhoodTable::build();
+
+public:
+    // Соседи клетки: сначала четыре по сторонам, затем четыре по диагоналям
+    static constexpr Coords around[8] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+    static constexpr int orthogonalCount = 4;
+
+    // Корабль с носом в top_left; координаты внутри наибольшего поля, длина допустимая
+    static constexpr const ShipArea& area(Coords top_left, int length, Orientation orientation) {
+        return areas[NeighborhoodTable::areaIndex(top_left.x, top_left.y, length, orientation == Orientation::Vertical)];
+    }
+
+    // Клетка с ее восемью соседями
+    static constexpr const ShipArea& cell(Coords coords) {
+        return areas[NeighborhoodTable::areaIndex(coords.x, coords.y, 1, false)];
+    }
+
+    static constexpr std::uint32_t columns(int width) {
+        return NeighborhoodTable::span(0, width - 1);
+    }
+
+    static bool shipIntersects(const Bitboard& board, const ShipArea& area) {
+        std::uint32_t found = 0;
+        for (int y = area.ship_first; y <= area.ship_last; ++y) {
+            found |= board.rows[y] & area.ship_mask;
+        }
+        return found != 0;
+    }
+
+    static void markShip(Bitboard& board, const ShipArea& area) {
+        for (int y = area.ship_first; y <= area.ship_last; ++y) {
+            board.rows[y] |= area.ship_mask;
+        }
+    }
+
+    // Ореол вместе с клетками корабля, обрезанный по полю width x height
+    static void markHalo(Bitboard& board, const ShipArea& area, int width, int height) {
+        std::uint32_t mask = area.halo_mask & columns(width);
+        int last = area.halo_last < height ? area.halo_last : height - 1;
+        for (int y = area.halo_first; y <= last; ++y) {
+            board.rows[y] |= mask;
+        }
+    }
+
+    // Обход клеток доски в пределах поля, строка за строкой
+    template <typename Visit>
+    static void forEachCell(const Bitboard& board, int width, int height, Visit visit) {
+        std::uint32_t mask = columns(width);
+        for (int y = 0; y < height; ++y) {
+            for (std::uint32_t row = board.rows[y] & mask; row != 0; row &= row - 1) {
+                visit(Coords {__builtin_ctz(row), y});
+            }
+        }
+    }
+
+    // Обход ореола вместе с клетками корабля
+    template <typename Visit>
+    static void forEachHaloCell(const ShipArea& area, int width, int height, Visit visit) {
+        std::uint32_t mask = area.halo_mask & columns(width);
+        int last = area.halo_last < height ? area.halo_last : height - 1;
+        for (int y = area.halo_first; y <= last; ++y) {
+            for (std::uint32_t row = mask; row != 0; row &= row - 1) {
+                visit(Coords {__builtin_ctz(row), y});
+            }
+        }
+    }
+};
+
+static_assert(Neighborhood::area({0, 0}, 2, Orientation::Horizontal).halo_mask == 0x7u, "halo is clipped at the left edge");
+static_assert(Neighborhood::area({3, 3}, 2, Orientation::Vertical).halo_first == 2 &&
+              Neighborhood::area({3, 3}, 2, Orientation::Vertical).halo_last == 5, "halo covers both ends");
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include "Ship.h"
+
+// Шаги, на которых игра спрашивает игрока
+enum class InputStep { LoadGame, SaveGame, UseAbility, Attack, PlayAgain };
+
+// Источник решений игрока. Game спрашивает: нужно ли действие (ask),
+// и затем его параметры (readFileName, readCoords).
+class PlayerInput {
+public:
+    virtual ~PlayerInput() = default;
+    virtual bool ask(InputStep step) = 0;
+    virtual std::string readFileName(InputStep step) = 0;
+    virtual Coords readCoords(InputStep step) = 0;
+    // Событие игры одной строкой ("shot player 3 4 hit"), для машинной обработки
+    virtual void report(const std::string& /*event*/) {}
+};
+
+// Вопросы в консоли и ответы из cin, как раньше
+class ConsoleInput : public PlayerInput {
+public:
+    bool ask(InputStep step) override;
+    std::string readFileName(InputStep step) override;
+    Coords readCoords(InputStep step) override;
+};
+
+// Сценарий игры из файла или канала. Весь сценарий читается и разбирается сразу,
+// дальше ответы берутся из памяти без обращения к потоку.
+// Команды (разделители - пробелы, переводы строк или ';', '#' - комментарий до конца строки):
+//   l <файл>   загрузить сохранение (при запуске или перед ходом)
+//   s <файл>   сохранить игру перед ходом
+//   u <x> <y>  применить способность
+//   a <x> <y>  атаковать
+//   r          после конца игры сыграть еще раз
+// На вопрос "да/нет" ответ "да", если следующая команда - та, что нужна на этом шаге.
+// Когда команды кончились, игра заканчивается (ScriptFinishedException).
+// Ошибка в сценарии пишется в results строкой "script_error <строка> <описание>"
+// и бросает ScriptErrorException.
+// События игры пишутся в results построчно.
+class ScriptInput : public PlayerInput {
+private:
+    struct Command {
+        char op;
+        std::string file_name;
+        Coords target {0, 0};
+        int line;
+    };
+
+    std::vector<Command> commands;
+    std::size_t next = 0;
+    std::size_t accepted = 0;          // команда, на которую ask ответил "да", плюс один; 0 - нет такой
+    std::ostream* results;
+
+    static char opFor(InputStep step);
+    void parse(const std::string& text);
+    [[noreturn]] void fail(int line, const std::string& message);
+
+public:
+    ScriptInput(std::istream& script, std::ostream* results = nullptr);
+
+    bool ask(InputStep step) override;
+    std::string readFileName(InputStep step) override;
+    Coords readCoords(InputStep step) override;
+    void report(const std::string& event) override;
+    bool isFinished() const;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "GameField.h"
+#include "TranspositionTable.h"
+
+// Что атакующий знает о клетке чужого поля
+enum class CellKnowledge : std::uint8_t { Open, Blocked, KnownShip };
+
+// Запись кэша карт вероятностей
+struct ProbabilityMapEntry {
+    std::uint8_t width;
+    std::uint8_t height;
+    float probability[maximalFieldSize * maximalFieldSize];
+};
+
+// Карта вероятностей нахождения живого сегмента в клетке.
+// Строится перебором всех допустимых положений оставшихся кораблей с учетом
+// промахов, попаданий, потопленных кораблей (и их ореолов) и результатов сканера.
+class ProbabilityMap {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<double> probability; // значения округлены до float, чтобы карта из кэша совпадала с построенной
+
+public:
+    ProbabilityMap() = default;
+    ProbabilityMap(int width, int height);
+
+    static std::vector<CellKnowledge> observe(const GameField& field, const std::vector<std::int8_t>& scanned);
+    static ProbabilityMap build(const GameField& field, const std::vector<int>& remaining_lengths,
+                                const std::vector<std::int8_t>& scanned);
+    // То же, но через общий кэш: разные порядки выстрелов часто приводят к одному и тому же знанию.
+    // key должен однозначно описывать наблюдение (см. EnemyAI::observationKey)
+    static ProbabilityMap cached(std::uint64_t key, const GameField& field, const std::vector<int>& remaining_lengths,
+                                 const std::vector<std::int8_t>& scanned);
+    static TranspositionTable<ProbabilityMapEntry>& sharedCache();
+
+    double at(Coords coords) const;
+    int getWidth() const;
+    int getHeight() const;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "SaveImage.h"
+#include "FileHandler.h"
+
+class Game;
+
+// Архив сохранений: много двоичных сохранений (BinarySave) в одном файле с индексом.
+// Формат: сигнатура "BARC", версия (u16), резерв (u16); записи подряд;
+// индекс - для каждой записи смещение (u64) и длина (u32);
+// в конце файла - смещение индекса (u64), число записей (u32) и сигнатура "BIDX".
+// Индекс пишется при finish(), поэтому архив без него (запись оборвалась) не открывается.
+class SaveArchiveWriter {
+private:
+    FileHandler file_handler;
+    std::vector<std::uint8_t> index;
+    std::uint64_t offset = 0;
+    std::size_t count = 0;
+    bool finished = false;
+
+public:
+    explicit SaveArchiveWriter(const std::string& file_name);
+    ~SaveArchiveWriter();
+    SaveArchiveWriter(const SaveArchiveWriter&) = delete;
+    SaveArchiveWriter& operator=(const SaveArchiveWriter&) = delete;
+
+    std::size_t add(const SaveImage& image); // возвращает номер записи
+    std::size_t add(Game& game);
+    void finish();
+};
+
+// Чтение архива через mmap: запись по номеру открывается без чтения остальных,
+// последовательный обход идет по отображению с подсказкой ядру о чтении подряд
+class SaveArchive {
+public:
+    struct Record {
+        const std::uint8_t* data;
+        std::size_t size;
+    };
+
+private:
+    const std::uint8_t* mapping = nullptr;
+    std::size_t mapping_size = 0;
+    const std::uint8_t* index = nullptr;
+    std::size_t count = 0;
+
+public:
+    explicit SaveArchive(const std::string& file_name);
+    ~SaveArchive();
+    SaveArchive(const SaveArchive&) = delete;
+    SaveArchive& operator=(const SaveArchive&) = delete;
+
+    std::size_t size() const;
+    Record record(std::size_t number) const;
+    SaveImage image(std::size_t number) const;
+    Game load(std::size_t number) const;
+    // Обход всех записей по порядку; остановиться можно, вернув false
+    void scan(const std::function<bool(std::size_t number, const SaveImage& image)>& visit) const;
+};
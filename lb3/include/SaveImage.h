@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "GameField.h"
+#include "ShipManager.h"
+#include "AbilityManager.h"
+
+class Game;
+
+// Формат файла сохранения. Auto - по расширению: ".bin" - двоичный, ".journal" - журнал, иначе JSON.
+enum class SaveFormat { Auto, Json, Binary, Journal };
+
+// Состояние игры в виде простых данных, без указателей между объектами.
+// Через него работают форматы сохранений, которым не нужно дерево json.
+struct SaveImage {
+    struct ShipImage {
+        Coords coords {0, 0};
+        Orientation orientation = Orientation::Horizontal;
+        std::vector<SegmentStatus> segments;
+    };
+
+    struct SideImage {
+        int width = 0;
+        int height = 0;
+        std::vector<Status> cells; // построчно, width * height
+        std::vector<ShipImage> ships;
+        std::vector<AbilityKind> abilities;
+    };
+
+    int round_counter = 0;
+    bool is_player_step = true;
+    bool is_player_use_ability = false;
+    bool is_player_do_attack = false;
+    SideImage player;
+    SideImage bot;
+
+    static SaveImage capture(Game& game);
+    static SideImage captureSide(const GameField& field, const ShipManager& manager, const AbilityManager& abilities);
+
+    // Проверка согласованности: размеры, границы и пересечения кораблей,
+    // каждая открытая клетка с кораблем принадлежит кораблю
+    void validate() const;
+    static void validateSide(const SideImage& side);
+
+    Game restore() const;
+    static GameField restoreField(const SideImage& side);
+    static ShipManager restoreShips(const SideImage& side, GameField& field);
+    static AbilityManager restoreAbilities(const SideImage& side);
+};
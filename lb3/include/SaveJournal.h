@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "SaveImage.h"
+
+class Game;
+
+// Журнал сохранений: двоичный снимок (BinarySave) и дописываемые после него пакеты записей хода.
+// Записи: выстрел, применение способности с исходом (клетка, по которой попал обстрел, или отказ -
+// способность снята с очереди без действия), выдача способности, и в конце пакета - номер раунда,
+// флаги хода и контрольная сумма пакета. Цель способности хранится как есть, 32-битным числом со знаком.
+// Все случайные исходы записываются явно, поэтому воспроизведение не зависит от генератора.
+// Автосохранение дописывает один пакет; раз в compactEvery пакетов, а также после смены
+// расстановки (новая игра, новый противник) журнал сворачивается в новый снимок.
+// Пакет без верной завершающей записи (оборванная запись) при загрузке отбрасывается.
+class SaveJournal {
+private:
+    std::string file_name;              // файл, в который дописываются пакеты; пусто - журнал не ведется
+    std::vector<std::uint8_t> pending;  // записи с последнего сохранения
+    int batches = 0;                    // пакетов после снимка
+
+    bool writeSnapshot(Game& game, const std::string& name);
+
+public:
+    static constexpr std::uint16_t version = 2; // версия 1 (цели способностей в u16) тоже читается
+    static constexpr int compactEvery = 64;
+
+    bool isActive() const;
+    void invalidate();
+    void recordShot(bool by_player, Coords target);
+    void recordAbility(bool by_player, const Ability& ability, Coords target);
+    void recordFailedAbility(bool by_player, AbilityKind kind, Coords target) noexcept;
+    void recordGrant(bool by_player, AbilityKind kind);
+    bool save(Game& game, const std::string& name);
+    int getBatchCount() const;
+
+    static bool isJournal(const std::vector<std::uint8_t>& data);
+    static std::vector<std::uint8_t> snapshot(const SaveImage& image);
+    static Game replay(const std::vector<std::uint8_t>& data);
+};
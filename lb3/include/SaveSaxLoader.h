@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "json.hpp"
+#include "SaveImage.h"
+
+// Потоковый загрузчик JSON-сохранений на SAX-интерфейсе json.hpp.
+// Токены сразу записываются в SaveImage, дерево json не строится.
+// Схема та же, что у GameState; порядок ключей произвольный, неизвестные ключи пропускаются.
+class SaveSaxLoader : public nlohmann::json_sax<nlohmann::json> {
+public:
+    // Какие части сохранения читать; остальные пропускаются без разбора.
+    // Заголовок - раунд, флаги хода и размеры полей - читается всегда.
+    enum Section : unsigned { Header = 0, PlayerSide = 1, BotSide = 2, AllSections = 3 };
+
+private:
+    enum class Frame { Root, Field, Row, Ships, Ship, ShipCoords, Segments, Segment, Abilities, Skip };
+
+    struct FieldRows {
+        std::vector<Status> cells; // строки подряд
+        int columns = -1;
+        int rows = 0;
+        int current = 0;           // длина текущей строки
+        std::string packed;        // поле строкой FieldCodec вместо массива строк
+    };
+
+    SaveImage image;
+    std::vector<Frame> frames;
+    std::string current_key; // последний ключ в текущем объекте
+    std::string root_key; // ключ корневого объекта, значение которого сейчас читается
+    int coord_index = 0;
+    FieldRows player_rows;
+    FieldRows bot_rows;
+    unsigned seen = 0;    // какие обязательные ключи встретились
+    unsigned sections = AllSections;
+    unsigned required = 0; // обязательные ключи для выбранных частей
+    bool stopped = false;  // нужные ключи прочитаны, разбор прерван
+
+    bool wanted(const std::string& name) const;
+
+    SaveImage::SideImage* sideFor(const std::string& name);
+    FieldRows* rowsFor(const std::string& name);
+    bool integer(std::int64_t value);
+    void markSeen(const std::string& name);
+    void finish();
+    static void shapeField(FieldRows& rows, SaveImage::SideImage& side);
+    template <typename Input>
+    static SaveImage parseInput(const Input& input, unsigned sections);
+
+public:
+    // Невыбранная сторона остается пустой (размеры поля заполнены)
+    static SaveImage parse(const std::vector<std::uint8_t>& data, unsigned sections = AllSections);
+    static SaveImage parse(const std::string& text, unsigned sections = AllSections);
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex) override;
+};
@@ -3,7 +3,12 @@
 #include "Ability.h"
 
 class Scanner : public Ability {
+private:
+    std::vector<Coords> found_segments; // результат последнего сканирования
+
 public:
     void apply(GameField& field, ShipManager& manager, Coords coords) override;
     std::string getName() const override;
+    AbilityKind getKind() const override;
+    const std::vector<Coords>& getFoundSegments() const;
 };
\ No newline at end of file
@@ -9,6 +9,8 @@ constexpr int maximalShipLength = 4;
 
 using namespace std;
 
+class LiveSegmentIndex;
+
 struct Coords {
     int x;
     int y;
@@ -24,6 +26,7 @@ public:
         Coords coords;
         SegmentStatus status { SegmentStatus::Intact };
         Ship* ship_pointer = nullptr;
+        int live_slot = -1; // позиция в LiveSegmentIndex, -1 если сегмент не учтен
 
         void setStatus(SegmentStatus new_status){
             status = new_status;
@@ -42,6 +45,8 @@ public:
     Ship& operator=(Ship&& other) noexcept;
 
     int getLength() const;
+    int getId() const; // номер среди активных кораблей флота, -1 - корабль не в строю
+    void setId(int new_id);
     int getMaxHealth();
     int getCurrentHealth();
     void setLength_and_health(int new_length);
@@ -58,6 +63,9 @@ public:
     void setCoords(const Coords& new_coords);
     void print_info() const;
     const std::vector<Ship::ShipSegment>& getSegments() const;
+    void attachLiveIndex(LiveSegmentIndex* index);
+    // Статусы сегментов из сохранения, без повторения выстрелов. Вызывается до attachLiveIndex
+    void restoreSegments(const std::vector<SegmentStatus>& statuses);
 
 private:
     int length;
@@ -65,5 +73,9 @@ private:
     Coords top_left;
     int max_health;
     int health;
+    int id = -1;
     std::vector<ShipSegment> segments;
+    LiveSegmentIndex* live_index = nullptr; // индекс живых сегментов флота, которому принадлежит корабль
+
+    void relinkSegments();
 };
\ No newline at end of file
@@ -1,13 +1,17 @@
 #pragma once
 #include <vector>
+#include <deque>
+#include <memory>
 #include "Ship.h"
+#include "LiveSegmentIndex.h"
 using namespace std;
 
 
 class ShipManager {
 private:
-    vector<Ship> free_ships;
+    deque<Ship> free_ships; // расстановка берет корабли из начала очереди
     vector<Ship> active_ships;
+    unique_ptr<LiveSegmentIndex> live_segments; // живые сегменты активных кораблей
 
 public:
     ShipManager(vector<int> sizes);
@@ -21,4 +25,8 @@ public:
     vector<Ship>& getActiveShips();
     void moveShipToActive(int index);
     vector<int> getShipSizes();
+    Ship::ShipSegment* getLiveSegment(int index); // index из [0, getLiveSegmentCount())
+    Ship::ShipSegment* getRandomLiveSegment();
+    int getLiveSegmentCount() const;
+    std::uint64_t getHash() const;
 };
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "Ship.h"
+
+// Прямоугольник клеток, границы включительно
+struct CellRect {
+    Coords first;
+    Coords last;
+};
+
+// Пространственный индекс кораблей поля: равномерная сетка корзин bucketSide x bucketSide.
+// Корабль записан в каждую корзину, которую задевает (корабль короче корзины, поэтому таких не больше двух).
+// В корзине хранится нос корабля: сегменты живут в куче корабля и не двигаются при перемещении
+// корабля между списками ShipManager, а ship_pointer сегмента всегда указывает на сам корабль.
+// Запрос прямоугольника обходит только задетые им корзины, поиск ближайшего - кольца корзин вокруг точки.
+class ShipSpatialIndex {
+private:
+    static constexpr int bucketShift = 5;
+    static constexpr int bucketSide = 1 << bucketShift;
+    static_assert(maximalShipLength <= bucketSide, "a ship must span at most two buckets");
+
+    int columns = 0;
+    int rows = 0;
+    std::vector<std::vector<const Ship::ShipSegment*>> buckets;
+
+    static CellRect extent(const Ship& ship);
+    static bool intersects(const CellRect& a, const CellRect& b);
+    static int distance(Coords point, const CellRect& rect); // по Чебышёву, 0 - точка внутри
+
+public:
+    ShipSpatialIndex() = default;
+    ShipSpatialIndex(int width, int height);
+
+    void add(const Ship& ship); // корабль уже расставлен (setShipCoordinates)
+    void clear();
+
+    // visit(const Ship&) для каждого корабля, пересекающего rect, ровно один раз
+    template <typename Visit>
+    void forEachShip(CellRect rect, Visit visit) const {
+        int first_column = std::max(rect.first.x, 0) >> bucketShift;
+        int first_row = std::max(rect.first.y, 0) >> bucketShift;
+        int last_column = std::min(rect.last.x >> bucketShift, columns - 1);
+        int last_row = std::min(rect.last.y >> bucketShift, rows - 1);
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int column = first_column; column <= last_column; ++column) {
+                for (const Ship::ShipSegment* bow : buckets[row * columns + column]) {
+                    const Ship& ship = *bow->ship_pointer;
+                    CellRect area = extent(ship);
+                    if (!intersects(area, rect)) {
+                        continue;
+                    }
+                    // Корабль из двух корзин сообщаем один раз: из корзины с углом пересечения
+                    int corner_x = std::max(area.first.x, rect.first.x) >> bucketShift;
+                    int corner_y = std::max(area.first.y, rect.first.y) >> bucketShift;
+                    if (corner_x == column && corner_y == row) {
+                        visit(ship);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<const Ship*> shipsIn(CellRect rect) const;
+    // Ближайший к точке непотопленный корабль (по Чебышёву до ближайшей клетки), nullptr - таких нет
+    const Ship* nearestAliveShip(Coords point) const;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GameEngine.h"
+#include "Neighborhood.h"
+
+// Политики безголовой симуляции для BasicGame: без ввода-вывода, сохранений и виртуальных вызовов в ходе
+
+// xorshift64*: состояние в одном слове, без глобального состояния rand()
+class FastRng {
+private:
+    std::uint64_t state;
+
+public:
+    explicit FastRng(std::uint64_t seed = 0x9E3779B97F4A7C15ULL) : state(seed ? seed : 1) {}
+
+    int operator()(int bound) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        std::uint64_t value = (state * 0x2545F4914F6CDD1DULL) >> 32;
+        return static_cast<int>((value * static_cast<std::uint64_t>(bound)) >> 32);
+    }
+};
+
+// Охота и добивание: случайная неоткрытая клетка, после попадания - та же клетка,
+// пока сегмент не уничтожен, и ее соседи по сторонам. Способности не применяет.
+class HuntEnemy {
+private:
+    static constexpr int randomAttempts = 64; // дальше - первая неоткрытая клетка по порядку
+
+    std::vector<Coords> targets;
+
+    static bool worthShooting(const GameField& field, Coords coords) {
+        const Cell* cell = field.findCell(coords);
+        if (cell == nullptr || cell->status_cell == Status::Empty) {
+            return false;
+        }
+        return cell->status_cell == Status::Unknown ||
+               (cell->ship_segment_pointer != nullptr && cell->ship_segment_pointer->status != SegmentStatus::Destroyed);
+    }
+
+    template <typename Engine>
+    static Coords search(Engine& game, const GameField& field) {
+        for (int attempt = 0; attempt < randomAttempts; ++attempt) {
+            Coords coords {game.random(field.getWidth()), game.random(field.getHeight())};
+            if (field.findCell(coords)->status_cell == Status::Unknown) {
+                return coords;
+            }
+        }
+        for (int y = 0; y < field.getHeight(); ++y) {
+            for (int x = 0; x < field.getWidth(); ++x) {
+                if (field.findCell({x, y})->status_cell == Status::Unknown) {
+                    return {x, y};
+                }
+            }
+        }
+        return {0, 0};
+    }
+
+public:
+    template <typename Engine>
+    void turn(Engine& game, bool by_player) {
+        const GameField& field = by_player ? game.getEnemyField() : game.getPlayerField();
+        while (!targets.empty() && !worthShooting(field, targets.back())) {
+            targets.pop_back();
+        }
+        Coords target = targets.empty() ? search(game, field) : targets.back();
+        AttackOutcome outcome = game.tryAttack(by_player, target);
+        if (outcome.result == AttackResult::Sunk) {
+            targets.clear(); // ореол потопленного корабля пуст
+        } else if (outcome.result == AttackResult::Hit) {
+            for (int i = 0; i < Neighborhood::orthogonalCount; ++i) {
+                Coords next {target.x + Neighborhood::around[i].x, target.y + Neighborhood::around[i].y};
+                if (worthShooting(field, next)) {
+                    targets.push_back(next);
+                }
+            }
+            targets.push_back(target); // поврежденный сегмент добивается первым
+        }
+    }
+
+    void reset() { targets.clear(); }
+};
+
+struct NullRenderer {
+    void shot(bool, Coords, AttackOutcome) {}
+    void ability(bool, const Ability&, Coords) {}
+    void frame(const GameField&, const GameField&, const AbilityManager&) {}
+};
+
+struct NullPersistence {
+    void recordShot(bool, Coords) {}
+    void recordAbility(bool, const Ability&, Coords) {}
+    void recordFailedAbility(bool, AbilityKind, Coords) noexcept {}
+    void recordGrant(bool, AbilityKind) {}
+};
+
+// Самоигра и стресс-прогоны: те же правила, что у Game, без консоли и журнала
+using SimulationGame = BasicGame<FastRng, HuntEnemy, NullRenderer, NullPersistence>;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Хеш-таблица с открытой адресацией (линейное пробирование) для клеток, в которых что-то произошло.
+// Ключ - упакованные координаты клетки. Записи не удаляются: корабль и выстрел остаются на поле
+// до конца партии, поэтому таблица только растет и удваивается при заполнении наполовину.
+// Ссылка на значение действительна до следующей вставки нового ключа.
+template <typename Value>
+class SparseCellTable {
+private:
+    static constexpr std::uint32_t emptyKey = 0xFFFFFFFFu;
+    static constexpr std::size_t initialCapacity = 64;
+
+    struct Slot {
+        std::uint32_t key = emptyKey;
+        Value value {};
+    };
+
+    std::vector<Slot> slots;
+    std::size_t count = 0;
+
+    // Перемешивание Фибоначчи: соседние клетки расходятся по таблице
+    static std::size_t home(std::uint32_t key, std::size_t mask) {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    }
+
+    std::size_t slotOf(std::uint32_t key) const {
+        std::size_t mask = slots.size() - 1;
+        std::size_t index = home(key, mask);
+        while (slots[index].key != key && slots[index].key != emptyKey) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(slots);
+        slots.assign(old.empty() ? initialCapacity : old.size() * 2, Slot());
+        for (Slot& slot : old) {
+            if (slot.key != emptyKey) {
+                slots[slotOf(slot.key)] = slot;
+            }
+        }
+    }
+
+public:
+    static std::uint32_t pack(int x, int y) {
+        return static_cast<std::uint32_t>(y) << 16 | static_cast<std::uint32_t>(x);
+    }
+
+    // nullptr - клетки в таблице нет
+    const Value* find(std::uint32_t key) const {
+        if (slots.empty()) {
+            return nullptr;
+        }
+        const Slot& slot = slots[slotOf(key)];
+        return slot.key == key ? &slot.value : nullptr;
+    }
+
+    // Клетка из таблицы; если ее нет - вставляется значение по умолчанию.
+    // Таблица растет только при вставке нового ключа: обращение к уже записанной клетке
+    // не перестраивает таблицу и не портит ссылки на другие значения.
+    Value& at(std::uint32_t key) {
+        if (!slots.empty()) {
+            Slot& slot = slots[slotOf(key)];
+            if (slot.key == key) {
+                return slot.value;
+            }
+        }
+        if ((count + 1) * 2 > slots.size()) {
+            grow();
+        }
+        Slot& slot = slots[slotOf(key)];
+        slot.key = key;
+        ++count;
+        return slot.value;
+    }
+
+    void clear() {
+        slots.clear();
+        count = 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    std::size_t memoryBytes() const {
+        return slots.capacity() * sizeof(Slot);
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Таблица транспозиций фиксированного размера, общая для нескольких потоков.
+// Каждая запись защищена seqlock: писатель захватывает запись CAS-ом счетчика
+// (если запись занята другим писателем, сохранение просто пропускается), читатель
+// копирует данные и проверяет, что счетчик не изменился. Блокировок нет, данные
+// хранятся в атомарных словах, поэтому одновременное чтение и запись корректны.
+// Таблица 4-ассоциативна: при вытеснении выбирается запись старшего поколения,
+// затем с меньшей глубиной (стоимостью повторного вычисления).
+template <typename Payload>
+class TranspositionTable {
+    static_assert(std::is_trivially_copyable<Payload>::value, "payload must be trivially copyable");
+
+private:
+    static constexpr int bucketSize = 4;
+    static constexpr std::size_t words = (sizeof(Payload) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct Entry {
+        std::atomic<std::uint32_t> sequence {0}; // нечетное значение - идет запись
+        std::atomic<std::uint32_t> meta {0};     // поколение (старшие 8 бит) и глубина (младшие 24)
+        std::atomic<std::uint64_t> key {0};
+        std::atomic<std::uint64_t> data[words];
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask;
+    std::atomic<std::uint32_t> generation {1};
+
+    static std::uint32_t packMeta(std::uint32_t generation, int depth) {
+        std::uint32_t clamped = depth < 0 ? 0 : (depth > 0xFFFFFF ? 0xFFFFFF : static_cast<std::uint32_t>(depth));
+        return (generation & 0xFF) << 24 | clamped;
+    }
+
+public:
+    // Размер округляется вверх до степени двойки
+    explicit TranspositionTable(std::size_t entry_count) {
+        std::size_t size = bucketSize;
+        while (size < entry_count) {
+            size <<= 1;
+        }
+        entries.reset(new Entry[size]);
+        mask = size - 1;
+        clear();
+    }
+
+    bool probe(std::uint64_t key, Payload& payload) const {
+        const Entry* bucket = &entries[key & mask & ~static_cast<std::size_t>(bucketSize - 1)];
+        for (int i = 0; i < bucketSize; ++i) {
+            const Entry& entry = bucket[i];
+            std::uint32_t before = entry.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0 || entry.key.load(std::memory_order_relaxed) != key) {
+                continue;
+            }
+            std::uint64_t buffer[words];
+            for (std::size_t w = 0; w < words; ++w) {
+                buffer[w] = entry.data[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) != before) {
+                return false; // запись изменилась во время чтения
+            }
+            std::memcpy(&payload, buffer, sizeof(Payload));
+            return true;
+        }
+        return false;
+    }
+
+    bool store(std::uint64_t key, const Payload& payload, int depth) {
+        Entry* bucket = &entries[key & mask & ~static_cast<std::size_t>(bucketSize - 1)];
+        std::uint32_t current = generation.load(std::memory_order_relaxed) & 0xFF;
+
+        Entry* victim = nullptr;
+        long victim_score = 0;
+        for (int i = 0; i < bucketSize; ++i) {
+            Entry& entry = bucket[i];
+            if (entry.key.load(std::memory_order_relaxed) == key) {
+                victim = &entry;
+                break;
+            }
+            std::uint32_t meta = entry.meta.load(std::memory_order_relaxed);
+            long age = static_cast<long>((current - (meta >> 24)) & 0xFF);
+            long score = static_cast<long>(meta & 0xFFFFFF) - (age << 24);
+            if (victim == nullptr || score < victim_score) {
+                victim = &entry;
+                victim_score = score;
+            }
+        }
+
+        std::uint32_t sequence = victim->sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) != 0 ||
+            !victim->sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) {
+            return false; // запись занята другим писателем, кэш - не источник истины
+        }
+        // Нечетный счетчик должен стать видимым раньше данных: в паре с acquire-барьером читателя
+        std::atomic_thread_fence(std::memory_order_release);
+        std::uint64_t buffer[words] = {};
+        std::memcpy(buffer, &payload, sizeof(Payload));
+        victim->key.store(key, std::memory_order_relaxed);
+        victim->meta.store(packMeta(current, depth), std::memory_order_relaxed);
+        for (std::size_t w = 0; w < words; ++w) {
+            victim->data[w].store(buffer[w], std::memory_order_relaxed);
+        }
+        victim->sequence.store(sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+    void newGeneration() {
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Не потокобезопасно: вызывается, когда таблицей никто не пользуется
+    void clear() {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            entries[i].sequence.store(0, std::memory_order_relaxed);
+            entries[i].meta.store(0, std::memory_order_relaxed);
+            entries[i].key.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t size() const {
+        return mask + 1;
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+// Ключи Зобриста для наблюдаемого состояния игры.
+// Ключи не хранятся в таблицах, а вычисляются смешиванием (splitmix64) номера признака,
+// поэтому подходят для поля любого размера и обходятся в несколько инструкций.
+class Zobrist {
+private:
+    static constexpr std::uint64_t cellSalt = 0x243F6A8885A308D3ULL;
+    static constexpr std::uint64_t segmentSalt = 0x13198A2E03707344ULL;
+    static constexpr std::uint64_t sunkSalt = 0xA4093822299F31D0ULL;
+    static constexpr std::uint64_t abilitySalt = 0x082EFA98EC4E6C89ULL;
+    static constexpr std::uint64_t scanSalt = 0x452821E638D01377ULL;
+    static constexpr std::uint64_t lengthSalt = 0xBE5466CF34E90C6CULL;
+
+    static constexpr std::uint64_t pack(int x, int y, int value) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) ^
+               (static_cast<std::uint64_t>(static_cast<std::uint32_t>(y)) << 4) ^
+               static_cast<std::uint64_t>(value);
+    }
+
+public:
+    // Множитель полиномиального хеша очереди способностей и обратный к нему по модулю 2^64
+    static constexpr std::uint64_t queueBase = 0x9E3779B97F4A7C15ULL;
+    static constexpr std::uint64_t queueBaseInverse() {
+        std::uint64_t inverse = queueBase; // метод Ньютона: каждая итерация удваивает число верных бит
+        for (int i = 0; i < 6; ++i) {
+            inverse *= 2 - queueBase * inverse;
+        }
+        return inverse;
+    }
+
+    static constexpr std::uint64_t mix(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    static constexpr std::uint64_t rotate(std::uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    // Статус клетки (0 - неизвестно, вклад нулевой)
+    static constexpr std::uint64_t cell(int x, int y, int status) {
+        return status == 0 ? 0 : mix(cellSalt ^ pack(x, y, status));
+    }
+
+    // Статус сегмента (0 - цел, вклад нулевой)
+    static constexpr std::uint64_t segment(int x, int y, int status) {
+        return status == 0 ? 0 : mix(segmentSalt ^ pack(x, y, status));
+    }
+
+    // Потопленный корабль, определяется координатами носа
+    static constexpr std::uint64_t sunkShip(int x, int y) {
+        return mix(sunkSalt ^ pack(x, y, 1));
+    }
+
+    static constexpr std::uint64_t ability(int kind) {
+        return mix(abilitySalt ^ static_cast<std::uint64_t>(kind)) | 1;
+    }
+
+    // Результат сканера в клетке (1 - корабль, -1 - пусто), известный только боту
+    static constexpr std::uint64_t scanned(int x, int y, int value) {
+        return value == 0 ? 0 : mix(scanSalt ^ pack(x, y, value > 0 ? 1 : 2));
+    }
+
+    // Непотопленный корабль длины length; ключи складываются, так что учитывается кратность
+    static constexpr std::uint64_t remainingShip(int length) {
+        return mix(lengthSalt ^ static_cast<std::uint64_t>(length));
+    }
+
+    static constexpr std::uint64_t sideToMove() {
+        return 0xB7E151628AED2A6BULL;
+    }
+};
+
+static_assert(Zobrist::queueBase * Zobrist::queueBaseInverse() == 1, "queue base must be invertible");
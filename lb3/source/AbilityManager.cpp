@@ -2,13 +2,11 @@
 #include "DoubleDamage.h"
 #include "Scanner.h"
 #include "Bombardment.h"
-#include <ctime>
+#include "Zobrist.h"
 #include <cstdlib>
 #include <iostream>
 
 AbilityManager::AbilityManager() {
-    srand(time(0));
-
     allAbilities.emplace_back(std::make_unique<DoubleDamage>());
     allAbilities.emplace_back(std::make_unique<Scanner>());
     allAbilities.emplace_back(std::make_unique<Bombardment>());
@@ -18,23 +16,41 @@ AbilityManager::AbilityManager() {
 
 AbilityManager::AbilityManager(AbilityManager&& other) noexcept
     : abilityQueue(std::move(other.abilityQueue)),
-      allAbilities(std::move(other.allAbilities)) {}
+      allAbilities(std::move(other.allAbilities)),
+      queue_hash(other.queue_hash),
+      queue_power(other.queue_power) {}
 
 AbilityManager& AbilityManager::operator=(AbilityManager&& other) noexcept {
     if (this != &other) {
         abilityQueue = std::move(other.abilityQueue);
         allAbilities = std::move(other.allAbilities);
+        queue_hash = other.queue_hash;
+        queue_power = other.queue_power;
     }
     return *this;
 }
 
 AbilityManager::AbilityManager(std::deque<std::unique_ptr<Ability>>&& initialQueue)
     : abilityQueue(std::move(initialQueue)) {
-    srand(time(0));
-
     allAbilities.emplace_back(std::make_unique<DoubleDamage>());
     allAbilities.emplace_back(std::make_unique<Scanner>());
     allAbilities.emplace_back(std::make_unique<Bombardment>());
+
+    for (const auto& ability : abilityQueue) {
+        hashPushBack(*ability);
+    }
+}
+
+std::unique_ptr<Ability> AbilityManager::createAbility(AbilityKind kind) {
+    switch (kind) {
+    case AbilityKind::DoubleDamage:
+        return std::make_unique<DoubleDamage>();
+    case AbilityKind::Scanner:
+        return std::make_unique<Scanner>();
+    case AbilityKind::Bombardment:
+        return std::make_unique<Bombardment>();
+    }
+    throw std::invalid_argument("Unknown ability kind");
 }
 
 void AbilityManager::grantRandomAbility() {
@@ -47,21 +63,30 @@ void AbilityManager::grantRandomAbility() {
         } else if (dynamic_cast<Bombardment*>(allAbilities[index].get())) {
             abilityQueue.push_back(std::make_unique<Bombardment>());
         }
+        hashPushBack(*abilityQueue.back());
     }
 }
 
-void AbilityManager::applyAbility(GameField& field, ShipManager& manager, Coords coords) {
+std::unique_ptr<Ability> AbilityManager::takeAbility() {
     if (abilityQueue.empty()) {
         throw NoAvailableAbilitiesException();
     }
 
     std::unique_ptr<Ability> ability = std::move(abilityQueue.front());
     abilityQueue.pop_front();
+    hashPopFront(*ability);
+    return ability;
+}
+
+std::unique_ptr<Ability> AbilityManager::applyAbility(GameField& field, ShipManager& manager, Coords coords) {
+    std::unique_ptr<Ability> ability = takeAbility();
     ability->apply(field, manager, coords);
+    return ability; // вызывающий может узнать результат применения (например, найденные сканером сегменты)
 }
 
 void AbilityManager::addAbility(std::unique_ptr<Ability> ability) {
     abilityQueue.push_back(std::move(ability));
+    hashPushBack(*abilityQueue.back());
 }
 
 void AbilityManager::printAbilities() const {
@@ -86,3 +111,26 @@ void AbilityManager::printAbilities() const {
 const std::deque<std::unique_ptr<Ability>>& AbilityManager::getQueue() const {
     return abilityQueue;
 }
+
+std::vector<AbilityKind> AbilityManager::getQueueKinds() const {
+    std::vector<AbilityKind> kinds;
+    for (const auto& ability : abilityQueue) {
+        kinds.push_back(ability->getKind());
+    }
+    return kinds;
+}
+
+void AbilityManager::hashPushBack(const Ability& ability) {
+    queue_hash += Zobrist::ability(static_cast<int>(ability.getKind())) * queue_power;
+    queue_power *= Zobrist::queueBase;
+}
+
+void AbilityManager::hashPopFront(const Ability& ability) {
+    constexpr std::uint64_t inverse = Zobrist::queueBaseInverse();
+    queue_hash = (queue_hash - Zobrist::ability(static_cast<int>(ability.getKind()))) * inverse;
+    queue_power *= inverse;
+}
+
+std::uint64_t AbilityManager::getHash() const {
+    return queue_hash;
+}
@@ -0,0 +1,76 @@
+#include "AnsiDiffRenderer.h"
+
+void AnsiDiffRenderer::moveTo(int row, int column) {
+    out += "\x1b[";
+    out += std::to_string(row + 1);
+    out += ';';
+    out += std::to_string(column + 1);
+    out += 'H';
+}
+
+void AnsiDiffRenderer::snapshot(const GameField& field, std::vector<char>& shadow) {
+    shadow.resize(field.getWidth() * field.getHeight());
+    for (int y = 0; y < field.getHeight(); ++y) {
+        for (int x = 0; x < field.getWidth(); ++x) {
+            shadow[y * field.getWidth() + x] = BoardRenderer::glyph(field.getCellAt({x, y}));
+        }
+    }
+}
+
+int AnsiDiffRenderer::frameRows() const {
+    // заголовки, строка координат, строки полей, строка способностей
+    return 2 + (player_height > enemy_height ? player_height : enemy_height) + 1;
+}
+
+void AnsiDiffRenderer::diffBoard(const GameField& field, std::vector<char>& shadow, int left) {
+    for (int y = 0; y < field.getHeight(); ++y) {
+        for (int x = 0; x < field.getWidth(); ++x) {
+            char glyph = BoardRenderer::glyph(field.getCellAt({x, y}));
+            char& shown = shadow[y * field.getWidth() + x];
+            if (glyph != shown) {
+                moveTo(2 + y, left + BoardRenderer::cellColumn(field, x));
+                out += glyph;
+                shown = glyph;
+            }
+        }
+    }
+}
+
+const std::string& AnsiDiffRenderer::update(const GameField& player, const GameField& enemy,
+                                            const AbilityManager& abilities) {
+    out.clear();
+    bool same_layout = player.getWidth() == player_width && player.getHeight() == player_height &&
+                       enemy.getWidth() == enemy_width && enemy.getHeight() == enemy_height;
+    if (!same_layout) {
+        player_width = player.getWidth();
+        player_height = player.getHeight();
+        enemy_width = enemy.getWidth();
+        enemy_height = enemy.getHeight();
+        out += "\x1b[H\x1b[2J";
+        out += full.frameFor(player, enemy, abilities);
+        snapshot(player, player_shadow);
+        snapshot(enemy, enemy_shadow);
+        ability_line = BoardRenderer::abilitiesLine(abilities);
+    } else {
+        diffBoard(player, player_shadow, 0);
+        diffBoard(enemy, enemy_shadow, BoardRenderer::boardWidth(player) + BoardRenderer::gap);
+        std::string line = BoardRenderer::abilitiesLine(abilities);
+        if (line != ability_line) {
+            moveTo(frameRows() - 1, 0);
+            out += "\x1b[2K";
+            out += line;
+            ability_line = line;
+        }
+    }
+    moveTo(frameRows(), 0);
+    out += "\x1b[J";
+    return out;
+}
+
+void AnsiDiffRenderer::invalidate() {
+    player_width = -1;
+}
+
+void AnsiDiffRenderer::emit() const {
+    BoardRenderer::write(out);
+}
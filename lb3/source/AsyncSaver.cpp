@@ -0,0 +1,104 @@
+#include "AsyncSaver.h"
+#include "BinarySave.h"
+#include "FileHandler.h"
+#include "FileExeption.h"
+#include <iostream>
+
+AsyncSaver::AsyncSaver() : worker(&AsyncSaver::run, this) {}
+
+AsyncSaver::~AsyncSaver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+std::shared_future<bool> AsyncSaver::submit(const std::string& file_name, SaveFormat format, SaveImage image,
+                                            Callback done) {
+    std::promise<bool> promise;
+    std::shared_future<bool> result = promise.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Job* job = nullptr;
+        for (Job& queued : jobs) {
+            if (queued.file_name == file_name) {
+                job = &queued;
+                break;
+            }
+        }
+        if (job == nullptr) {
+            jobs.emplace_back();
+            job = &jobs.back();
+            job->file_name = file_name;
+        }
+        job->format = format;
+        job->image = std::move(image);
+        job->promises.push_back(std::move(promise));
+        if (done) {
+            job->callbacks.push_back(std::move(done));
+        }
+    }
+    wake.notify_one();
+    return result;
+}
+
+void AsyncSaver::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && !busy; });
+}
+
+void AsyncSaver::run() {
+    std::deque<Job> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            busy = false;
+            if (jobs.empty()) {
+                idle.notify_all();
+            }
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return; // остановка, и все записано
+            }
+            batch.swap(jobs);
+            busy = true;
+        }
+
+        for (Job& job : batch) {
+            bool saved = write(job);
+            for (std::promise<bool>& promise : job.promises) {
+                promise.set_value(saved);
+            }
+            for (Callback& callback : job.callbacks) {
+                callback(job.file_name, saved);
+            }
+        }
+        batch.clear();
+    }
+}
+
+bool AsyncSaver::write(Job& job) {
+    try {
+        FileHandler file_handler(job.file_name);
+        if (job.format == SaveFormat::Binary) {
+            std::vector<std::uint8_t> data = BinarySave::encode(job.image);
+            file_handler.writeDurable(reinterpret_cast<const char*>(data.data()), data.size());
+        } else {
+            const std::string& text = writer.write(job.image);
+            file_handler.writeDurable(text.data(), text.size());
+        }
+        return true;
+    } catch (const FileExeption& e) {
+        std::cerr << "Error while saving game state: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error while encoding game state: " << e.what() << std::endl;
+    }
+    return false;
+}
+
+AsyncSaver& AsyncSaver::shared() {
+    static AsyncSaver saver;
+    return saver;
+}
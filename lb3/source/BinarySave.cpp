@@ -0,0 +1,171 @@
+#include "BinarySave.h"
+#include "ByteStream.h"
+#include "FieldCodec.h"
+#include <algorithm>
+#include <stdexcept>
+
+static const std::uint8_t magic[4] = {'B', 'S', 'A', 'V'};
+
+namespace {
+
+void writeSide(ByteWriter& writer, const SaveImage::SideImage& side) {
+    writer.u16(side.width);
+    writer.u16(side.height);
+    std::vector<std::uint8_t> packed;
+    FieldCodec::encode(side.cells.data(), side.cells.size(), packed);
+    writer.bytes(packed); // длина не пишется: поток заканчивается на последней клетке
+
+    writer.u16(side.ships.size());
+    for (const SaveImage::ShipImage& ship : side.ships) {
+        int length = ship.segments.size();
+        if (length < minimalShipLength || length > maximalShipLength) {
+            throw std::runtime_error("Ship length does not fit into binary save");
+        }
+        writer.u16(ship.coords.x);
+        writer.u16(ship.coords.y);
+        writer.u8((ship.orientation == Orientation::Vertical ? 0x80 : 0) | length);
+        int statuses = 0;
+        for (int j = 0; j < length; ++j) {
+            statuses |= static_cast<int>(ship.segments[j]) << (2 * j);
+        }
+        writer.u8(statuses);
+    }
+
+    writer.u16(side.abilities.size());
+    for (AbilityKind kind : side.abilities) {
+        writer.u8(static_cast<int>(kind));
+    }
+}
+
+SaveImage::SideImage readSide(ByteReader& reader, int file_version) {
+    SaveImage::SideImage side;
+    side.width = reader.u16();
+    side.height = reader.u16();
+    if (side.width < minimalFieldSize || side.width > maximalFieldSize ||
+        side.height < minimalFieldSize || side.height > maximalFieldSize) {
+        throw std::runtime_error("Invalid field size in binary save");
+    }
+    int cells = side.width * side.height;
+    side.cells.assign(cells, Status::Unknown);
+    if (file_version >= 2) {
+        reader.bytes(FieldCodec::decode(reader.current(), reader.remaining(), side.cells.data(), cells));
+    }
+    for (int plane = 0; plane < 2 && file_version == 1; ++plane) {
+        for (int base = 0; base < cells; base += 8) {
+            int bits = reader.u8();
+            for (int i = base; i < base + 8 && i < cells; ++i) {
+                if ((bits >> (i - base) & 1) == 0) {
+                    continue;
+                }
+                side.cells[i] = plane == 0 ? Status::Empty : Status::Ship;
+            }
+        }
+    }
+
+    side.ships.resize(reader.u16());
+    for (SaveImage::ShipImage& ship : side.ships) {
+        ship.coords.x = reader.u16();
+        ship.coords.y = reader.u16();
+        int packed = reader.u8();
+        ship.orientation = (packed & 0x80) != 0 ? Orientation::Vertical : Orientation::Horizontal;
+        int length = packed & 0x7F;
+        if (length < minimalShipLength || length > maximalShipLength) {
+            throw std::runtime_error("Invalid ship length in binary save");
+        }
+        int statuses = reader.u8();
+        for (int j = 0; j < length; ++j) {
+            int status = statuses >> (2 * j) & 3;
+            if (status > static_cast<int>(SegmentStatus::Destroyed)) {
+                throw std::runtime_error("Invalid segment status in binary save");
+            }
+            ship.segments.push_back(static_cast<SegmentStatus>(status));
+        }
+    }
+
+    int abilities = reader.u16();
+    for (int i = 0; i < abilities; ++i) {
+        int code = reader.u8();
+        if (code >= abilityKindCount) {
+            throw std::runtime_error("Unknown ability code in binary save");
+        }
+        side.abilities.push_back(static_cast<AbilityKind>(code));
+    }
+    return side;
+}
+
+}
+
+std::uint32_t BinarySave::checksum(const std::uint8_t* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool BinarySave::isBinary(const std::vector<std::uint8_t>& data) {
+    return data.size() >= sizeof(magic) && std::equal(magic, magic + sizeof(magic), data.begin());
+}
+
+std::vector<std::uint8_t> BinarySave::encode(const SaveImage& image) {
+    std::vector<std::uint8_t> data(magic, magic + sizeof(magic));
+    ByteWriter writer(data);
+    writer.u16(version);
+    writer.u32(static_cast<std::uint32_t>(image.round_counter));
+    writer.u8((image.is_player_step ? 1 : 0) | (image.is_player_use_ability ? 2 : 0) | (image.is_player_do_attack ? 4 : 0));
+    writeSide(writer, image.player);
+    writeSide(writer, image.bot);
+    writer.u32(checksum(data.data(), data.size()));
+    return data;
+}
+
+SaveImage BinarySave::decode(const std::vector<std::uint8_t>& data) {
+    return decode(data.data(), data.size());
+}
+
+SaveImage BinarySave::decodeHeader(const std::uint8_t* data, std::size_t size) {
+    if (size < sizeof(magic) + 4 || !std::equal(magic, magic + sizeof(magic), data)) {
+        throw std::runtime_error("Not a binary save");
+    }
+    ByteReader reader(data, sizeof(magic), size - 4);
+    int file_version = reader.u16();
+    if (file_version < 1 || file_version > version) {
+        throw std::runtime_error("Unsupported binary save version " + std::to_string(file_version));
+    }
+    SaveImage image;
+    image.round_counter = static_cast<int>(reader.u32());
+    int flags = reader.u8();
+    image.is_player_step = (flags & 1) != 0;
+    image.is_player_use_ability = (flags & 2) != 0;
+    image.is_player_do_attack = (flags & 4) != 0;
+    return image;
+}
+
+SaveImage BinarySave::decode(const std::uint8_t* data, std::size_t size) {
+    if (size < sizeof(magic) + 4 || !std::equal(magic, magic + sizeof(magic), data)) {
+        throw std::runtime_error("Not a binary save");
+    }
+    std::size_t body = size - 4;
+    ByteReader tail(data, body, size);
+    if (tail.u32() != checksum(data, body)) {
+        throw std::runtime_error("Binary save checksum mismatch");
+    }
+
+    ByteReader reader(data, sizeof(magic), body);
+    int file_version = reader.u16();
+    if (file_version < 1 || file_version > version) {
+        throw std::runtime_error("Unsupported binary save version " + std::to_string(file_version));
+    }
+    SaveImage image;
+    image.round_counter = static_cast<int>(reader.u32());
+    int flags = reader.u8();
+    image.is_player_step = (flags & 1) != 0;
+    image.is_player_use_ability = (flags & 2) != 0;
+    image.is_player_do_attack = (flags & 4) != 0;
+    image.player = readSide(reader, file_version);
+    image.bot = readSide(reader, file_version);
+    if (!reader.atEnd()) {
+        throw std::runtime_error("Unexpected data after binary save");
+    }
+    return image;
+}
@@ -0,0 +1,156 @@
+#include "BoardRenderer.h"
+#include <iostream>
+#include <cstdio>
+#include <unistd.h>
+
+static int digits(int value) {
+    int count = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++count;
+    }
+    return count;
+}
+
+char BoardRenderer::glyph(const Cell& cell) {
+    if (cell.ship_is_here) {
+        switch (cell.ship_segment_pointer->status) {
+        case SegmentStatus::Damaged:
+            return '1';
+        case SegmentStatus::Destroyed:
+            return '0';
+        default:
+            return '2';
+        }
+    }
+    return cell.missed ? 'x' : '.';
+}
+
+void BoardRenderer::appendNumber(int value, int width) {
+    char text[12];
+    int length = 0;
+    do {
+        text[length++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    if (width > length) {
+        frame.append(width - length, ' ');
+    }
+    while (length > 0) {
+        frame += text[--length];
+    }
+}
+
+void BoardRenderer::appendPadded(const char* text, int width) {
+    int shown = 0;
+    for (const char* c = text; *c != '\0'; ++c) {
+        frame += *c;
+        if ((*c & 0xC0) != 0x80) {
+            ++shown; // байты продолжения UTF-8 не занимают места
+        }
+    }
+    if (width > shown) {
+        frame.append(width - shown, ' ');
+    }
+}
+
+int BoardRenderer::boardWidth(const GameField& field) {
+    return digits(field.getHeight() - 1) + field.getWidth() * (digits(field.getWidth() - 1) + 1);
+}
+
+int BoardRenderer::cellColumn(const GameField& field, int x) {
+    return digits(field.getHeight() - 1) + x * (digits(field.getWidth() - 1) + 1) + digits(field.getWidth() - 1);
+}
+
+std::string BoardRenderer::abilitiesLine(const AbilityManager& abilities) {
+    if (abilities.getQueue().empty()) {
+        return "Способностей нет";
+    }
+    std::string line = "Способности:";
+    for (const auto& ability : abilities.getQueue()) {
+        line += ' ';
+        line += ability->getName();
+    }
+    return line;
+}
+
+void BoardRenderer::boardHeader(const GameField& field) {
+    int cell_width = digits(field.getWidth() - 1) + 1;
+    frame.append(digits(field.getHeight() - 1), ' ');
+    for (int x = 0; x < field.getWidth(); ++x) {
+        appendNumber(x, cell_width);
+    }
+}
+
+void BoardRenderer::boardRow(const GameField& field, int y) {
+    int cell_width = digits(field.getWidth() - 1) + 1;
+    appendNumber(y, digits(field.getHeight() - 1));
+    for (int x = 0; x < field.getWidth(); ++x) {
+        frame.append(cell_width - 1, ' ');
+        frame += glyph(field.getCellAt({x, y}));
+    }
+}
+
+const std::string& BoardRenderer::board(const GameField& field) {
+    frame.clear();
+    frame.reserve((boardWidth(field) + 1) * (field.getHeight() + 1));
+    boardHeader(field);
+    frame += '\n';
+    for (int y = 0; y < field.getHeight(); ++y) {
+        boardRow(field, y);
+        frame += '\n';
+    }
+    return frame;
+}
+
+const std::string& BoardRenderer::frameFor(const GameField& player, const GameField& enemy,
+                                           const AbilityManager& abilities) {
+    int left = boardWidth(player) + gap;
+    int rows = player.getHeight() > enemy.getHeight() ? player.getHeight() : enemy.getHeight();
+    frame.clear();
+    frame.reserve((left + boardWidth(enemy) + 1) * (rows + 3) + 64 + abilities.getQueue().size() * 16);
+
+    appendPadded("Поле игрока:", left);
+    frame += "Поле врага:\n";
+    boardHeader(player);
+    frame.append(gap, ' ');
+    boardHeader(enemy);
+    frame += '\n';
+    for (int y = 0; y < rows; ++y) {
+        std::size_t start = frame.size();
+        if (y < player.getHeight()) {
+            boardRow(player, y);
+        }
+        frame.append(left - (frame.size() - start), ' ');
+        if (y < enemy.getHeight()) {
+            boardRow(enemy, y);
+        }
+        frame += '\n';
+    }
+
+    frame += abilitiesLine(abilities);
+    frame += '\n';
+    return frame;
+}
+
+const std::string& BoardRenderer::getFrame() const {
+    return frame;
+}
+
+void BoardRenderer::emit() const {
+    write(frame);
+}
+
+void BoardRenderer::write(const std::string& text) {
+    // Все, что уже выведено через cout, должно оказаться раньше кадра
+    std::cout.flush();
+    std::fflush(stdout);
+    std::size_t written = 0;
+    while (written < text.size()) {
+        ssize_t count = ::write(STDOUT_FILENO, text.data() + written, text.size() - written);
+        if (count <= 0) {
+            return;
+        }
+        written += count;
+    }
+}
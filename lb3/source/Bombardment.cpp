@@ -4,23 +4,35 @@
 #include <iostream>
 
 void Bombardment::apply(GameField& field, ShipManager& manager, Coords coords) {
-    if (!manager.getActiveShips().empty()) {
-        int shipIndex = rand() % manager.getActiveShips().size();
-        Ship& ship = manager.getActiveShips()[shipIndex];
-        Ship::ShipSegment* segment = nullptr;
-        int maxAttempts = ship.getLength();
-
-        while (maxAttempts-- > 0) {
-            int segmentIndex = rand() % ship.getLength();
-            segment = const_cast<Ship::ShipSegment*>(ship.getSegmentByIndex(segmentIndex));
-            if (segment != nullptr && segment->status != SegmentStatus::Destroyed) {
-                segment->ship_pointer->damageSegment(const_cast<Ship::ShipSegment*>(segment), 1);
-                break;
-            }
-        }
+    // Сегмент выбирается равновероятно среди живых сегментов флота, поэтому удар всегда достигает цели
+    Ship::ShipSegment* segment = nullptr;
+    if (preset) {
+        segment = field.getCellAt(hit_coords).ship_segment_pointer;
+        preset = false;
+    } else {
+        segment = manager.getRandomLiveSegment();
+    }
+    hit = segment != nullptr;
+    if (segment != nullptr) {
+        hit_coords = segment->coords;
+        segment->ship_pointer->damageSegment(segment, 1);
     }
 }
 
+bool Bombardment::getHit(Coords& coords) const {
+    coords = hit_coords;
+    return hit;
+}
+
+void Bombardment::presetTarget(Coords coords) {
+    preset = true;
+    hit_coords = coords;
+}
+
 std::string Bombardment::getName() const {
     return "Bombardment";
 }
+
+AbilityKind Bombardment::getKind() const {
+    return AbilityKind::Bombardment;
+}
@@ -0,0 +1,54 @@
+#include "ConsolePolicies.h"
+#include <string>
+
+static const char* attackResultName(AttackResult result) {
+    switch (result) {
+    case AttackResult::Miss:
+        return "miss";
+    case AttackResult::Hit:
+        return "hit";
+    case AttackResult::Sunk:
+        return "sunk";
+    case AttackResult::AlreadyShot:
+        return "already";
+    default:
+        return "out";
+    }
+}
+
+void ConsoleRenderer::setAnsiRendering(bool enabled) {
+    ansiRendering = enabled;
+    diffRenderer.invalidate();
+}
+
+bool ConsoleRenderer::getAnsiRendering() const {
+    return ansiRendering;
+}
+
+void ConsoleRenderer::setResults(std::shared_ptr<PlayerInput> new_results) {
+    results = std::move(new_results);
+}
+
+void ConsoleRenderer::shot(bool by_player, Coords target, AttackOutcome outcome) {
+    if (results) {
+        results->report(std::string("shot ") + (by_player ? "player " : "enemy ") + std::to_string(target.x) + " " +
+                        std::to_string(target.y) + " " + attackResultName(outcome.result));
+    }
+}
+
+void ConsoleRenderer::ability(bool by_player, const Ability& used, Coords target) {
+    if (results) {
+        results->report(std::string("ability ") + (by_player ? "player " : "enemy ") + used.getName() + " " +
+                        std::to_string(target.x) + " " + std::to_string(target.y));
+    }
+}
+
+void ConsoleRenderer::frame(const GameField& player, const GameField& enemy, const AbilityManager& abilities) {
+    if (ansiRendering) {
+        diffRenderer.update(player, enemy, abilities);
+        diffRenderer.emit();
+        return;
+    }
+    renderer.frameFor(player, enemy, abilities);
+    renderer.emit();
+}
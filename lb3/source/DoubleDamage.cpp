@@ -6,13 +6,17 @@ void DoubleDamage::apply(GameField& field, ShipManager& manager, Coords coords)
     Cell& cell = field.getCellAt(coords);
     if (cell.ship_is_here) {
         cell.ship_segment_pointer->ship_pointer->damageSegment(cell.ship_segment_pointer, 2);
-        cell.status_cell = Status::Ship; // Изменяем статус клетки на корабль
+        field.setCellStatus(coords, Status::Ship); // Изменяем статус клетки на корабль
     }
     else {
-        cell.status_cell = Status::Empty; // Изменяем статус клетки на корабль
+        field.setCellStatus(coords, Status::Empty); // Изменяем статус клетки на корабль
     }
 }
 
 std::string DoubleDamage::getName() const {
     return "DoubleDamage";
 }
+
+AbilityKind DoubleDamage::getKind() const {
+    return AbilityKind::DoubleDamage;
+}
@@ -0,0 +1,174 @@
+#include "EnemyAI.h"
+#include "DoubleDamage.h"
+#include "Scanner.h"
+#include "Bombardment.h"
+#include "Zobrist.h"
+#include <cmath>
+
+void EnemyAI::reset() {
+    width = 0;
+    height = 0;
+    scanned.clear();
+    ProbabilityMap::sharedCache().newGeneration();
+}
+
+void EnemyAI::fitTo(const GameField& field) {
+    if (field.getWidth() != width || field.getHeight() != height) {
+        width = field.getWidth();
+        height = field.getHeight();
+        scanned.assign(width * height, 0);
+    }
+}
+
+std::vector<int> EnemyAI::remainingLengths(ShipManager& manager) {
+    std::vector<int> lengths;
+    for (const auto& ship : manager.getActiveShips()) {
+        if (ship.isAlive()) { // о потоплении корабля противник узнает сразу
+            lengths.push_back(ship.getLength());
+        }
+    }
+    return lengths;
+}
+
+bool EnemyAI::isTarget(const GameField& field, Coords coords) {
+    const Cell& cell = field.getCellAt(coords);
+    if (cell.status_cell == Status::Unknown) {
+        // Сегмент, уничтоженный обстрелом бота, остается в неоткрытой клетке: выстрел по нему пропадет
+        return cell.ship_segment_pointer == nullptr || cell.ship_segment_pointer->status != SegmentStatus::Destroyed;
+    }
+    // Раненый сегмент добивается вторым выстрелом
+    return cell.status_cell == Status::Ship && cell.ship_segment_pointer != nullptr &&
+           cell.ship_segment_pointer->status == SegmentStatus::Damaged;
+}
+
+double EnemyAI::entropy(double p) {
+    if (p <= 0.0 || p >= 1.0) {
+        return 0.0;
+    }
+    return -p * std::log2(p) - (1.0 - p) * std::log2(1.0 - p);
+}
+
+std::uint64_t EnemyAI::observationKey(const GameField& field, ShipManager& manager,
+                                      const std::vector<std::int8_t>& scanned) {
+    std::uint64_t key = field.getHash() ^ Zobrist::rotate(manager.getHash(), 17) ^
+                        Zobrist::mix(static_cast<std::uint64_t>(field.getWidth()) << 8 | field.getHeight());
+    std::uint64_t fleet = 0;
+    for (int length : remainingLengths(manager)) {
+        fleet += Zobrist::remainingShip(length);
+    }
+    key ^= Zobrist::rotate(fleet, 29);
+    for (int i = 0; i < static_cast<int>(scanned.size()); ++i) {
+        key ^= Zobrist::scanned(i % field.getWidth(), i / field.getWidth(), scanned[i]);
+    }
+    return key;
+}
+
+ProbabilityMap EnemyAI::buildMap(const GameField& field, ShipManager& manager) {
+    fitTo(field);
+    return ProbabilityMap::cached(observationKey(field, manager, scanned), field, remainingLengths(manager), scanned);
+}
+
+double EnemyAI::bestShotDamage(const GameField& field, const ProbabilityMap& map, Coords& best) const {
+    double best_value = -1.0;
+    for (int y = 0; y < field.getHeight(); ++y) {
+        for (int x = 0; x < field.getWidth(); ++x) {
+            if (!isTarget(field, {x, y})) {
+                continue;
+            }
+            double value = field.getCellAt({x, y}).status_cell == Status::Ship ? 1.0 : map.at({x, y});
+            if (value > best_value) {
+                best_value = value;
+                best = {x, y};
+            }
+        }
+    }
+    return best_value < 0.0 ? 0.0 : best_value;
+}
+
+AbilityDecision EnemyAI::planAbility(const Ability& ability, const GameField& field, ShipManager& manager) {
+    ProbabilityMap map = buildMap(field, manager);
+    AbilityDecision decision;
+    Coords shot_target {0, 0};
+    double shot_damage = bestShotDamage(field, map, shot_target);
+
+    if (dynamic_cast<const DoubleDamage*>(&ability)) {
+        // Двойной урон по нетронутой клетке уничтожает сегмент сразу: 2 * p против урона обычного выстрела
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (field.getCellAt({x, y}).status_cell != Status::Unknown || !isTarget(field, {x, y})) {
+                    continue;
+                }
+                double value = 2.0 * map.at({x, y});
+                if (value > decision.value) {
+                    decision.value = value;
+                    decision.target = {x, y};
+                }
+            }
+        }
+        decision.shot_value = shot_damage;
+    } else if (dynamic_cast<const Scanner*>(&ability)) {
+        // Сканер открывает окно 2x2: сумма энтропий неизвестных клеток против энтропии одного выстрела
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                double value = 0.0;
+                for (int sy = y; sy < y + 2 && sy < height; ++sy) {
+                    for (int sx = x; sx < x + 2 && sx < width; ++sx) {
+                        if (scanned[sy * width + sx] == 0 && field.getCellAt({sx, sy}).status_cell == Status::Unknown) {
+                            value += entropy(map.at({sx, sy}));
+                        }
+                    }
+                }
+                if (value > decision.value) {
+                    decision.value = value;
+                    decision.target = {x, y};
+                }
+            }
+        }
+        decision.shot_value = field.getCellAt(shot_target).status_cell == Status::Unknown ? entropy(map.at(shot_target)) : 0.0;
+    } else if (dynamic_cast<const Bombardment*>(&ability)) {
+        // Обстрел всегда попадает в живой сегмент: ровно одна единица урона
+        decision.value = manager.getLiveSegmentCount() > 0 ? 1.0 : 0.0;
+        decision.shot_value = shot_damage;
+        decision.use = decision.value > 0.0 && decision.value >= decision.shot_value;
+        return decision;
+    }
+
+    decision.use = decision.value > decision.shot_value;
+    return decision;
+}
+
+Coords EnemyAI::chooseShot(const GameField& field, ShipManager& manager) {
+    ProbabilityMap map = buildMap(field, manager);
+    Coords best {0, 0};
+    bestShotDamage(field, map, best);
+    return best;
+}
+
+void EnemyAI::observeAbility(const Ability& ability, Coords target, const GameField& field) {
+    fitTo(field);
+    // Обстрел сообщает клетку попадания, но не меняет ее статус: бот запоминает ее как клетку корабля
+    const Bombardment* bombardment = dynamic_cast<const Bombardment*>(&ability);
+    Coords hit {0, 0};
+    if (bombardment != nullptr && bombardment->getHit(hit) && field.coordinatsInField(hit)) {
+        scanned[hit.y * width + hit.x] = 1;
+        return;
+    }
+    const Scanner* scanner = dynamic_cast<const Scanner*>(&ability);
+    if (scanner == nullptr) {
+        return;
+    }
+    for (int y = target.y; y < target.y + 2; ++y) {
+        for (int x = target.x; x < target.x + 2; ++x) {
+            if (field.coordinatsInField({x, y})) {
+                scanned[y * width + x] = -1;
+            }
+        }
+    }
+    for (const Coords& found : scanner->getFoundSegments()) {
+        scanned[found.y * width + found.x] = 1;
+    }
+}
+
+const std::vector<std::int8_t>& EnemyAI::getScanned() const {
+    return scanned;
+}
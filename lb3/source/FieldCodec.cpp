@@ -0,0 +1,365 @@
+#include "FieldCodec.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const int longRun = 31;
+static const std::size_t maximalLiteral = 128;
+static const std::size_t stackBytes = 1024; // поток поля 25x25 всегда помещается, куча не нужна
+
+static_assert(sizeof(Status) == 1, "cells are packed and compared as bytes");
+
+namespace {
+
+// Таблицы строятся при компиляции: байт упакованного блока -> четыре статуса (байты слова, первый - младший),
+// символ base64 -> его значение (-1 - недопустимый символ)
+struct CodecTables {
+    std::uint32_t unpack[256] = {};
+    std::int8_t base64[256] = {};
+
+    constexpr CodecTables() {
+        for (int byte = 0; byte < 256; ++byte) {
+            for (int i = 0; i < 4; ++i) {
+                unpack[byte] |= static_cast<std::uint32_t>(byte >> (2 * i) & 3) << (8 * i);
+            }
+            base64[byte] = -1;
+        }
+        for (int value = 0; value < 64; ++value) {
+            base64[static_cast<unsigned char>(base64Alphabet[value])] = static_cast<std::int8_t>(value);
+        }
+    }
+};
+
+constexpr CodecTables tables;
+
+// Верхняя граница длины потока: самый дорогой случай - одиночная клетка между сериями
+// (2 байта на клетку блока и 1 байт на серию из 4), то есть меньше байта на клетку
+std::size_t encodedBound(std::size_t count) {
+    return count + 16;
+}
+
+// Конец серии клеток, равных cells[i]: сравнение по 8 клеток за раз
+std::size_t runEnd(const Status* cells, std::size_t i, std::size_t count) {
+    std::uint64_t pattern = static_cast<std::uint64_t>(cells[i]) * 0x0101010101010101ULL;
+    std::size_t end = i + 1;
+    while (end + 8 <= count) {
+        std::uint64_t word;
+        std::memcpy(&word, cells + end, sizeof(word));
+        std::uint64_t diff = word ^ pattern;
+        if (diff != 0) {
+            return end + (__builtin_ctzll(diff) >> 3); // первая отличная клетка - младший байт (little-endian)
+        }
+        end += 8;
+    }
+    while (end < count && cells[end] == cells[i]) {
+        ++end;
+    }
+    return end;
+}
+
+// 8 клеток -> 2 байта (первая клетка - младшие биты): два младших бита каждого байта
+// сдвигаются к соседям за три шага
+std::uint32_t pack8(const Status* cells) {
+    std::uint64_t word;
+    std::memcpy(&word, cells, sizeof(word));
+    word = (word | word >> 6) & 0x000F000F000F000FULL;
+    word = (word | word >> 12) & 0x000000FF000000FFULL;
+    return static_cast<std::uint32_t>((word | word >> 24) & 0xFFFF);
+}
+
+// readable - сколько клеток можно прочитать от cells (не меньше count)
+std::uint8_t* writeLiteral(const Status* cells, std::size_t count, std::size_t readable, std::uint8_t* out) {
+    if (count > 0 && count <= 16 && readable >= 16) {
+        // Короткий блок (самый частый между сериями) - без циклов: 16 клеток и маска лишних
+        std::uint32_t packed = pack8(cells) | pack8(cells + 8) << 16;
+        packed &= count == 16 ? ~0u : (1u << (2 * count)) - 1;
+        *out = static_cast<std::uint8_t>(count - 1);
+        std::memcpy(out + 1, &packed, sizeof(packed)); // little-endian: байты в порядке клеток
+        return out + 1 + (count + 3) / 4;
+    }
+    while (count > 0) {
+        std::size_t block = count < maximalLiteral ? count : maximalLiteral;
+        *out++ = static_cast<std::uint8_t>(block - 1);
+        std::size_t full = block / 4;
+        std::size_t k = 0;
+        for (; k + 2 <= full; k += 2) {
+            std::uint32_t packed = pack8(cells + 4 * k);
+            *out++ = static_cast<std::uint8_t>(packed);
+            *out++ = static_cast<std::uint8_t>(packed >> 8);
+        }
+        if (k < full) {
+            std::uint32_t word;
+            std::memcpy(&word, cells + 4 * k, sizeof(word));
+            *out++ = static_cast<std::uint8_t>((word & 0x3) | (word >> 6 & 0xC) | (word >> 12 & 0x30) | (word >> 18 & 0xC0));
+        }
+        if (block % 4 != 0) {
+            int bits = 0;
+            for (std::size_t i = 4 * full; i < block; ++i) {
+                bits |= static_cast<int>(cells[i]) << (2 * (i - 4 * full));
+            }
+            *out++ = static_cast<std::uint8_t>(bits);
+        }
+        cells += block;
+        count -= block;
+    }
+    return out;
+}
+
+std::uint8_t* writeRun(Status status, std::size_t length, std::uint8_t* out) {
+    int head = 0x80 | static_cast<int>(status) << 5;
+    if (length <= longRun) {
+        *out++ = static_cast<std::uint8_t>(head | (length - 1));
+        return out;
+    }
+    *out++ = static_cast<std::uint8_t>(head | longRun);
+    std::size_t rest = length - longRun - 1;
+    while (rest >= 0x80) {
+        *out++ = static_cast<std::uint8_t>(0x80 | (rest & 0x7F));
+        rest >>= 7;
+    }
+    *out++ = static_cast<std::uint8_t>(rest);
+    return out;
+}
+
+// Бит j: клетка base + j начинает серию (отличается от предыдущей). Клетки за концом поля тоже
+// считаются началами серий, чтобы последняя серия заканчивалась на count.
+std::uint64_t runStarts(const Status* cells, std::size_t count, std::size_t base) {
+    if (base >= count) {
+        return ~0ULL;
+    }
+    std::uint64_t bits = 0;
+    for (std::size_t k = 0; k < 64; k += 16) {
+        std::size_t first = base + k;
+        if (first == 0 || first + 16 > count) {
+            for (std::size_t j = 0; j < 16; ++j) {
+                std::size_t i = first + j;
+                bool start = i == 0 || i >= count || cells[i] != cells[i - 1];
+                bits |= static_cast<std::uint64_t>(start) << (k + j);
+            }
+            continue;
+        }
+#ifdef __SSE2__
+        // 16 клеток одним сравнением: маска равных соседей
+        __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + first));
+        __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + first - 1));
+        std::uint64_t equal = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(current, previous)));
+        bits |= (~equal & 0xFFFF) << k;
+#else
+        // По 8 клеток: байты разности сворачиваются в младшие биты и собираются умножением
+        for (std::size_t half = 0; half < 16; half += 8) {
+            std::uint64_t current;
+            std::uint64_t previous;
+            std::memcpy(&current, cells + first + half, sizeof(current));
+            std::memcpy(&previous, cells + first + half - 1, sizeof(previous));
+            std::uint64_t diff = current ^ previous; // статусы меньше 4: разность в двух младших битах байта
+            std::uint64_t flags = (diff | diff >> 1) & 0x0101010101010101ULL;
+            bits |= (flags * 0x0102040810204080ULL >> 56) << (k + half);
+        }
+#endif
+    }
+    return bits;
+}
+
+// Поток в out (не меньше encodedBound(count) байт); возвращает длину.
+// Длинные серии находятся по битовым маскам начал серий, поэтому ветвления - на длинную серию,
+// а не на каждую клетку; клетки между ними упаковываются блоками.
+std::size_t encodeTo(const Status* cells, std::size_t count, std::uint8_t* out) {
+    static_assert(FieldCodec::minimalRun == 4, "long run mask checks three following cells");
+    std::uint8_t* begin = out;
+    std::size_t literal = 0; // начало еще не записанных клеток
+    std::uint64_t starts = runStarts(cells, count, 0);
+    for (std::size_t base = 0; base < count; base += 64) {
+        std::uint64_t next = runStarts(cells, count, base + 64);
+        std::uint64_t after1 = starts >> 1 | next << 63;
+        std::uint64_t after2 = starts >> 2 | next << 62;
+        std::uint64_t after3 = starts >> 3 | next << 61;
+        // Серия не короче minimalRun: начало, за которым три клетки без нового начала
+        for (std::uint64_t long_runs = starts & ~(after1 | after2 | after3); long_runs != 0; long_runs &= long_runs - 1) {
+            int j = __builtin_ctzll(long_runs);
+            std::size_t i = base + j;
+            // Конец серии - следующее начало; по клеткам ищется, только если серия длиннее маски
+            std::uint64_t later = j == 63 ? 0 : starts >> (j + 1);
+            std::size_t end = later != 0 ? i + 1 + __builtin_ctzll(later)
+                              : next != 0 ? base + 64 + __builtin_ctzll(next)
+                                          : runEnd(cells, i, count);
+            out = writeLiteral(cells + literal, i - literal, count - literal, out);
+            out = writeRun(cells[i], end - i, out);
+            literal = end;
+        }
+        starts = next;
+    }
+    out = writeLiteral(cells + literal, count - literal, count - literal, out);
+    return out - begin;
+}
+}
+
+void FieldCodec::encode(const Status* cells, std::size_t count, std::vector<std::uint8_t>& out) {
+    if (encodedBound(count) > stackBytes) {
+        std::size_t start = out.size();
+        out.resize(start + encodedBound(count));
+        out.resize(start + encodeTo(cells, count, out.data() + start));
+        return;
+    }
+    std::uint8_t stack[stackBytes]; // без обнуления запаса в out
+    out.insert(out.end(), stack, stack + encodeTo(cells, count, stack));
+}
+
+std::size_t FieldCodec::decode(const std::uint8_t* data, std::size_t size, Status* cells, std::size_t count) {
+    std::size_t position = 0;
+    std::size_t filled = 0;
+    while (filled < count) {
+        if (position >= size) {
+            throw std::runtime_error("Packed field is truncated");
+        }
+        int head = data[position++];
+        if ((head & 0x80) != 0) {
+            int status = head >> 5 & 3;
+            std::size_t length = (head & longRun) + 1;
+            if ((head & longRun) == longRun) {
+                std::size_t rest = 0;
+                for (int shift = 0;; shift += 7) {
+                    if (position >= size || shift > 56) {
+                        throw std::runtime_error("Packed field is truncated");
+                    }
+                    int part = data[position++];
+                    rest |= static_cast<std::size_t>(part & 0x7F) << shift;
+                    if ((part & 0x80) == 0) {
+                        break;
+                    }
+                }
+                length = longRun + 1 + rest;
+            }
+            if (status > static_cast<int>(Status::Ship) || length > count - filled) {
+                throw std::runtime_error("Invalid packed field");
+            }
+            if (length <= 32 && count - filled >= 32) {
+                std::memset(cells + filled, status, 32); // постоянная длина - две записи без цикла
+            } else {
+                std::memset(cells + filled, status, length);
+            }
+            filled += length;
+        } else {
+            std::size_t block = head + 1;
+            if (block > count - filled || size - position < (block + 3) / 4) {
+                throw std::runtime_error("Invalid packed field");
+            }
+            if (block <= 16 && count - filled >= 16 && size - position >= 4) {
+                // Короткий блок: 4 байта разом, лишние клетки перезапишут следующие токены
+                std::uint32_t word;
+                std::memcpy(&word, data + position, sizeof(word));
+                word &= block == 16 ? ~0u : (1u << (2 * block)) - 1;
+                if ((word & word >> 1 & 0x55555555u) != 0) {
+                    throw std::runtime_error("Invalid packed field");
+                }
+                for (int k = 0; k < 4; ++k) {
+                    std::memcpy(cells + filled + 4 * k, &tables.unpack[word >> (8 * k) & 0xFF], 4);
+                }
+                position += (block + 3) / 4;
+                filled += block;
+                continue;
+            }
+            std::size_t full = block / 4;
+            int invalid = 0; // пара бит 11 - статуса 3 не бывает
+            for (std::size_t k = 0; k < full; ++k) {
+                int byte = data[position + k];
+                invalid |= byte & byte >> 1 & 0x55;
+                std::memcpy(cells + filled + 4 * k, &tables.unpack[byte], 4);
+            }
+            std::size_t tail = block % 4;
+            if (tail != 0) {
+                int byte = data[position + full] & ((1 << (2 * tail)) - 1);
+                invalid |= byte & byte >> 1 & 0x55;
+                std::memcpy(cells + filled + 4 * full, &tables.unpack[byte], tail);
+            }
+            if (invalid != 0) {
+                throw std::runtime_error("Invalid packed field");
+            }
+            position += (block + 3) / 4;
+            filled += block;
+        }
+    }
+    return position;
+}
+
+void FieldCodec::encodeText(const Status* cells, std::size_t count, std::string& out) {
+    std::uint8_t stack[stackBytes];
+    std::vector<std::uint8_t> heap; // только для полей больше классических
+    std::uint8_t* bytes = stack;
+    if (encodedBound(count) > stackBytes) {
+        heap.resize(encodedBound(count));
+        bytes = heap.data();
+    }
+    std::size_t size = encodeTo(cells, count, bytes);
+
+    std::size_t start = out.size();
+    out.resize(start + (size + 2) / 3 * 4);
+    char* text = &out[start];
+    std::size_t i = 0;
+    for (; i + 2 < size; i += 3) {
+        std::uint32_t group = bytes[i] << 16 | bytes[i + 1] << 8 | bytes[i + 2];
+        *text++ = base64Alphabet[group >> 18];
+        *text++ = base64Alphabet[group >> 12 & 63];
+        *text++ = base64Alphabet[group >> 6 & 63];
+        *text++ = base64Alphabet[group & 63];
+    }
+    if (i < size) {
+        std::uint32_t group = bytes[i] << 16 | (i + 1 < size ? bytes[i + 1] << 8 : 0);
+        *text++ = base64Alphabet[group >> 18];
+        *text++ = base64Alphabet[group >> 12 & 63];
+        *text++ = i + 1 < size ? base64Alphabet[group >> 6 & 63] : '=';
+        *text++ = '=';
+    }
+}
+
+void FieldCodec::decodeText(const std::string& text, Status* cells, std::size_t count) {
+    std::size_t length = text.size();
+    while (length > 0 && text[length - 1] == '=') {
+        --length;
+    }
+    std::uint8_t stack[stackBytes];
+    std::vector<std::uint8_t> heap;
+    std::uint8_t* bytes = stack;
+    if (length * 3 / 4 > stackBytes) {
+        heap.resize(length * 3 / 4);
+        bytes = heap.data();
+    }
+    // Четыре символа - три байта; недопустимый символ дает отрицательное значение и портит знак check
+    std::size_t size = 0;
+    std::size_t i = 0;
+    int check = 0;
+    const std::int8_t* values = tables.base64;
+    for (; i + 4 <= length; i += 4) {
+        int a = values[static_cast<unsigned char>(text[i])];
+        int b = values[static_cast<unsigned char>(text[i + 1])];
+        int c = values[static_cast<unsigned char>(text[i + 2])];
+        int d = values[static_cast<unsigned char>(text[i + 3])];
+        check |= a | b | c | d;
+        std::uint32_t group = static_cast<std::uint32_t>(a) << 18 | b << 12 | c << 6 | d;
+        bytes[size] = static_cast<std::uint8_t>(group >> 16);
+        bytes[size + 1] = static_cast<std::uint8_t>(group >> 8);
+        bytes[size + 2] = static_cast<std::uint8_t>(group);
+        size += 3;
+    }
+    std::uint32_t group = 0;
+    int bits = 0;
+    for (; i < length; ++i) {
+        int value = values[static_cast<unsigned char>(text[i])];
+        check |= value;
+        group = group << 6 | (value & 63);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            bytes[size++] = static_cast<std::uint8_t>(group >> bits & 0xFF);
+        }
+    }
+    if (check < 0) {
+        throw std::runtime_error("Invalid character in packed field");
+    }
+    if (decode(bytes, size, cells, count) != size) {
+        throw std::runtime_error("Unexpected data after packed field");
+    }
+}
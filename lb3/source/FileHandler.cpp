@@ -1,22 +1,32 @@
 #include "FileHandler.h"
 #include "FileExeption.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
 
 FileHandler::FileHandler(const std::string& file_name) : file_name(file_name) {}
 
 void FileHandler::openForRead() {
-    input_file.open(file_name);
+    input_file.open(file_name, std::ios::binary);
     if (!input_file.is_open()) {
         throw FileExeption("Can't open file for reading");
     }
 }
 
 void FileHandler::openForWrite() {
-    output_file.open(file_name);
+    output_file.open(file_name, std::ios::binary);
     if (!output_file.is_open()) {
         throw FileExeption("Can't open file for writing.");
     }
 }
 
+void FileHandler::openForAppend() {
+    output_file.open(file_name, std::ios::binary | std::ios::app);
+    if (!output_file.is_open()) {
+        throw FileExeption("Can't open file for appending.");
+    }
+}
+
 void FileHandler::write(const nlohmann::json& info) {
     if (output_file.is_open()) {
         output_file << info.dump(4);
@@ -33,6 +43,68 @@ void FileHandler::read(nlohmann::json& info) {
     }
 }
 
+void FileHandler::writeText(const std::string& text) {
+    if (!output_file.is_open()) {
+        throw FileExeption("File not open for writing.");
+    }
+    output_file.write(text.data(), text.size());
+    if (!output_file) {
+        throw FileExeption("Write failed.");
+    }
+}
+
+void FileHandler::writeBytes(const std::vector<std::uint8_t>& data) {
+    if (!output_file.is_open()) {
+        throw FileExeption("File not open for writing.");
+    }
+    output_file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!output_file) {
+        throw FileExeption("Write failed.");
+    }
+}
+
+void FileHandler::readBytes(std::vector<std::uint8_t>& data) {
+    if (!input_file.is_open()) {
+        throw FileExeption("File not open for reading.");
+    }
+    data.assign(std::istreambuf_iterator<char>(input_file), std::istreambuf_iterator<char>());
+}
+
+void FileHandler::writeDurable(const char* data, std::size_t size) {
+    std::string temp_name = file_name + ".tmp";
+    int fd = ::open(temp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw FileExeption("Can't open file for writing.");
+    }
+    std::size_t written = 0;
+    while (written < size) {
+        ssize_t count = ::write(fd, data + written, size - written);
+        if (count < 0) {
+            ::close(fd);
+            std::remove(temp_name.c_str());
+            throw FileExeption("Write failed.");
+        }
+        written += count;
+    }
+    if (::fsync(fd) != 0 || ::close(fd) != 0) {
+        std::remove(temp_name.c_str());
+        throw FileExeption("Write failed.");
+    }
+    if (std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+        std::remove(temp_name.c_str());
+        throw FileExeption("Can't replace the save file.");
+    }
+
+    // Переименование становится постоянным после fsync каталога
+    std::string::size_type slash = file_name.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : file_name.substr(0, slash == 0 ? 1 : slash);
+    int dir_fd = ::open(directory.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+
 void FileHandler::closeRead() {
     if (input_file.is_open()) {
         input_file.close();
@@ -10,20 +10,23 @@
 #include <memory>
 
 
-Game::Game()
-    : playerField(10, 10), enemyField(10, 10),
-    playerShipManager({2, 1}), enemyShipManager({2, 1}),
-    playerAbilitiesManager() {}
+void Game::setInput(shared_ptr<PlayerInput> new_input) {
+    input = std::move(new_input);
+    view.setResults(input);
+}
 
 void Game::initializeGame() {
     roundCounter = 0; // Обнуляем счетчик раундов
+    persistence.invalidate(); // новая расстановка - следующее сохранение начнет журнал со снимка
     vector<int> ship_sizes = {2, 1};  // Пример размеров кораблей
 
-    playerField = GameField(10, 10);
-    enemyField = GameField(10, 10);
+    playerField = GameField(classicFieldSize, classicFieldSize);
+    enemyField = GameField(classicFieldSize, classicFieldSize);
 
     playerShipManager = ShipManager(ship_sizes);
     enemyShipManager = ShipManager(ship_sizes);
+    enemy.reset(); // знания бота относятся к старому полю игрока
+    MctsAI::sharedCache().newGeneration();
 
     // Инициализируем поля с кораблями
 
@@ -54,23 +57,17 @@ void Game::initializeGame() {
     }
 
     // Вывод начального состояния поля
-    cout << "Поле игрока:\n";
-    playerField.print_field();
-    cout << "Поле врага:\n";
-    enemyField.print_field();
+    print_fields();
 }
 
 void Game::print_fields(){
-    // Вывод загруженного состояния поля
-    cout << "Поле игрока:\n";
-    playerField.print_field();
-    cout << "Поле врага:\n";
-    enemyField.print_field();
+    render();
 }
 
 void Game::resetEnemy() {
+    persistence.invalidate();
     vector<int> shipSizes = {2, 3, 1};
-    enemyField = GameField(10, 10);
+    enemyField = GameField(classicFieldSize, classicFieldSize);
     enemyShipManager = ShipManager(shipSizes);
 
     // Размещение кораблей врага на поле
@@ -87,68 +84,126 @@ void Game::resetEnemy() {
     enemyShipManager.moveShipToActive(0);
 }
 
+bool Game::writeSave(const string& file_name) {
+    SaveFormat format = saveFormat == SaveFormat::Auto ? GameState::formatForFile(file_name) : saveFormat;
+    if (format == SaveFormat::Json) {
+        return GameState::saveText(file_name, saveWriter.write(*this));
+    } else if (format == SaveFormat::Journal) {
+        return persistence.save(*this, file_name); // дописывает ходы с прошлого сохранения
+    } else {
+        return GameState(*this, format).save(file_name);
+    }
+}
+
 void Game::saveGame(const string& file_name) {
-    GameState state(*this);
-    if (state.save(file_name)) {
+    SaveFormat format = saveFormat == SaveFormat::Auto ? GameState::formatForFile(file_name) : saveFormat;
+    if (format != SaveFormat::Journal) {
+        queueSave(file_name, true);
+        cout << "Saving game to " << file_name << " in background...\n";
+        return;
+    }
+    bool saved = writeSave(file_name);
+    if (saved) {
         cout << "Game saved successfully to " << file_name << "\n";
     } else {
         cerr << "Failed to save the game.\n";
     }
 }
 
+// Снимок состояния уходит потоку записи, ход продолжается сразу
+void Game::queueSave(const string& file_name, bool report) {
+    SaveFormat format = saveFormat == SaveFormat::Auto ? GameState::formatForFile(file_name) : saveFormat;
+    if (format == SaveFormat::Journal) {
+        if (!writeSave(file_name)) {
+            cerr << "Failed to save the game.\n";
+        }
+        return;
+    }
+    pendingSaves.push_back({file_name, AsyncSaver::shared().submit(file_name, format, SaveImage::capture(*this)), report});
+}
+
+void Game::reportSaves(bool wait) {
+    while (!pendingSaves.empty()) {
+        PendingSave& pending = pendingSaves.front();
+        if (!wait && pending.saved.wait_for(chrono::seconds(0)) != future_status::ready) {
+            break;
+        }
+        if (!pending.saved.get()) {
+            cerr << "Failed to save the game to " << pending.file_name << ".\n";
+        } else if (pending.report) {
+            cout << "Game saved successfully to " << pending.file_name << "\n";
+        }
+        pendingSaves.pop_front();
+    }
+}
+
 // Новый метод для загрузки игры
 bool Game::loadGame(const string& file_name) {
-    GameState state(file_name);
+    AsyncSaver::shared().flush(); // файл мог еще писаться в фоне
+    reportSaves(true);
     try {
+        GameState state(file_name);
+        Difficulty current_difficulty = getDifficulty(); // сложность и формат - настройки, а не часть сохранения
+        SaveFormat current_format = saveFormat;
+        string current_autosave = autosaveFile;
+        bool current_ansi = view.getAnsiRendering();
+        shared_ptr<PlayerInput> current_input = input;
         *this = state.load();
+        setInput(current_input);
+        setDifficulty(current_difficulty);
+        saveFormat = current_format;
+        autosaveFile = current_autosave;
+        setAnsiRendering(current_ansi);
         cout << "Game loaded successfully from " << file_name << "\n";
+        input->report("load ok " + file_name);
         return true;
     } catch (const exception& e) {
         cerr << "Failed to load the game: " << e.what() << "\n";
     } catch (...) {
         cerr << "An unknown error occurred during game loading.\n";
     }
+    input->report("load failed " + file_name);
     return false;
 }
 
 void Game::startGame(int loaded=0) {
-    while (true) {
-        if (loaded == 0){
-            initializeGame();
-        }
-        else{
-            print_fields();
-        }
-        while (playRound()) {
-            cout << "Игрок выиграл раунд!\nПерезапускаем врага...\n";
-            resetEnemy();
-            cout << "Поле игрока:\n";
-            playerField.print_field();
-            cout << "Поле врага:\n";
-            enemyField.print_field();
+    try {
+        while (true) {
+            if (loaded == 0){
+                initializeGame();
+            }
+            else{
+                print_fields();
+            }
+            while (playRound()) {
+                cout << "Игрок выиграл раунд!\nПерезапускаем врага...\n";
+                input->report("round_won " + to_string(roundCounter));
+                resetEnemy();
+                print_fields();
+            }
+
+            reportSaves(true);
+            input->report("game_over " + to_string(roundCounter));
+            cout << "Game over!\n";
+            if (!input->ask(InputStep::PlayAgain)) break;
+            loaded = 0;
         }
-
-        cout << "Game over!\nСыграем еще раз? (y/n): ";
-        char answer;
-        cin >> answer;
-        if (answer != 'y') break;
+    } catch (const ScriptFinishedException&) {
+        reportSaves(true); // сценарий кончился посреди игры
+        input->report("script_end " + to_string(roundCounter));
     }
 }
 
 
 void Game::playerTurn(int& enemyShipCount) {
+    reportSaves(false);
     ++roundCounter; // Увеличиваем счетчик раундов
     isPlayerUseAbility = false;
     isPlayerDoAttack = false;
 
     // Предложить игроку загрузить сохранение перед ходом
-    cout << "Хотите загрузить игру? (y/n): ";
-    char answer;
-    cin >> answer;
-    if (answer == 'y') {
-        string file_name;
-        cout << "Введите имя файла: ";
-        cin >> file_name;
+    if (input->ask(InputStep::LoadGame)) {
+        string file_name = input->readFileName(InputStep::LoadGame);
         if (loadGame(file_name)) {
             cout << "Сохранение загружено. Начинаем ход заново с текущего состояния игры.\n";
             return; // Выход из метода, чтобы игрок начал новый ход с загруженного состояния
@@ -156,13 +211,10 @@ void Game::playerTurn(int& enemyShipCount) {
     }
 
     // Предложить игроку сохранить игру перед ходом
-    cout << "Хотите сохранить игру? (y/n): ";
-    cin >> answer;
-    if (answer == 'y') {
-        string file_name;
-        cout << "Введите имя файла: ";
-        cin >> file_name;
+    if (input->ask(InputStep::SaveGame)) {
+        string file_name = input->readFileName(InputStep::SaveGame);
         saveGame(file_name);
+        input->report("save " + file_name);
     }
 
     isPlayerStep = true; // Устанавливаем флаг, что сейчас ход игрока
@@ -170,78 +222,36 @@ void Game::playerTurn(int& enemyShipCount) {
     // Вывод доступных способностей
     cout << "\nДоступные способности:\n";
     playerAbilitiesManager.printAbilities();
-    cout << "Вы хотите использовать способность? y/n\n";
-    cin >> answer;
 
-    if (answer == 'y') {
+    if (input->ask(InputStep::UseAbility)) {
         try {
-            int x, y;
-            cout << "Введите координаты для применения способности (x y): ";
-            cin >> x >> y;
-
-            Coords target1 = {x, y};
-            playerAbilitiesManager.applyAbility(enemyField, enemyShipManager, target1);
+            Coords target1 = input->readCoords(InputStep::UseAbility);
+            useAbility(true, target1);
             isPlayerUseAbility = true;
         } catch (const NoAvailableAbilitiesException& e) {
             cerr << "Ошибка применения способности " << e.what() << "\n";
+        } catch (const OutOfFieldAttackException& e) {
+            cerr << "Ошибка применения способности " << e.what() << "\n"; // способность потрачена, ход продолжается
         } catch (const logic_error& e) {
             cerr << e.what() << endl;
         }
     }
 
-    try {
-        int x, y;
-        cout << "Введите координаты атаки (x y): ";
-        cin >> x >> y;
-
-        enemyField.attackCell({x, y});
+    Coords target = input->readCoords(InputStep::Attack); // конец сценария прерывает игру, а не ход
+    if (tryAttack(true, target).result == AttackResult::OutOfBounds) {
+        cerr << OutOfFieldAttackException().what() << " Check attack coordinates." << endl;
+    } else {
         isPlayerDoAttack = true;
-
-    } catch (const OutOfFieldAttackException& e) {
-        cerr << e.what() << " Check attack coordinates." << endl;
-    } catch (const exception& e) {
-        cerr << "Invalid attack: " << e.what() << "\n";
     }
 
-    if (enemyShipCount > enemyShipManager.getAliveShipsNumber()) {
-        int destroyedShips = enemyShipCount - enemyShipManager.getAliveShipsNumber();
-        for (int i = 0; i < destroyedShips; ++i) {
-            isPlayerUseAbility = false;
-            playerAbilitiesManager.grantRandomAbility();
-        }
-        enemyShipCount = enemyShipManager.getAliveShipsNumber();
+    if (rewardSunk(true, enemyShipCount)) {
+        isPlayerUseAbility = false;
     }
     // Ход передается боту
     isPlayerStep = false;
 }
 
 
-void Game::enemyTurn(int& playerShipCount) {
-    isPlayerStep = false; // Устанавливаем флаг, что сейчас ход игрока
-
-    while (true) {
-        try {
-            int x = rand() % playerField.getWidth();
-            int y = rand() % playerField.getHeight();
-
-            cout << "Атака врага (" << x << ", " << y << ")\n";
-            playerField.attackCell({x, y});
-            break;
-        } catch (const OutOfFieldAttackException& e) {
-            cerr << e.what() << " Check attack coordinates." << endl;
-        } catch (const exception& e) {
-            cerr << "Enemy attack failed: " << e.what() << "\n";
-        }
-    }
-
-    if (playerShipCount > playerShipManager.getAliveShipsNumber()) {
-        playerShipCount = playerShipManager.getAliveShipsNumber();
-    }
-    // Передача хода обратно игроку
-    isPlayerStep = true;
-    isPlayerDoAttack = false;
-}
-
 bool Game::playRound() {
     int playerShipCount = playerShipManager.getAliveShipsNumber();
     int enemyShipCount = enemyShipManager.getAliveShipsNumber();
@@ -253,13 +263,13 @@ bool Game::playRound() {
         }
 
         enemyTurn(playerShipCount);
+        if (!autosaveFile.empty()) {
+            queueSave(autosaveFile, false);
+        }
         if (playerShipCount == 0) {
             return false;
         }
 
-        cout << "Поле игрока:\n";
-        playerField.print_field();
-        cout << "Поле врага:\n";
-        enemyField.print_field();
+        print_fields();
     }
 }
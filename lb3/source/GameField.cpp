@@ -1,32 +1,46 @@
 #include "GameField.h"
+#include "Zobrist.h"
+#include "BoardRenderer.h"
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 
 GameField::GameField() {
     height = 0;
     width = 0;
-    field;
 }
 
-GameField::GameField(int new_width, int new_height) {
-    if (new_width < minimalFieldSize || new_height < minimalFieldSize || new_width > maximalFieldSize || new_height > maximalFieldSize) {
+GameField::GameField(int new_width, int new_height) : GameField(new_width, new_height, FieldMode::Classic) {}
+
+GameField::GameField(int new_width, int new_height, FieldMode new_mode) {
+    int limit = new_mode == FieldMode::Classic ? maximalFieldSize : maximalLargeFieldSize;
+    if (new_width < minimalFieldSize || new_height < minimalFieldSize || new_width > limit || new_height > limit) {
         throw std::logic_error("Invalid field size");
     }
-    width = new_width;
-    height = new_height;
-    field.resize(height, std::vector<Cell>(width));
+    allocate(new_width, new_height, new_mode);
 }
 
 GameField::GameField(const GameField& other) {
     width = other.width;
     height = other.height;
-    field = other.field;
+    copyCells(other);
+    ship_index = other.ship_index;
+    zobrist = other.zobrist;
+    ships = other.ships;
+    occupied = other.occupied;
 }
 
 GameField::GameField(GameField&& other) noexcept {
     width = std::move(other.width);
     height = std::move(other.height);
-    field = std::move(other.field);
+    mode = other.mode;
+    chunk_columns = other.chunk_columns;
+    chunks = std::move(other.chunks);
+    sparse = std::move(other.sparse);
+    ship_index = std::move(other.ship_index);
+    zobrist = other.zobrist;
+    ships = other.ships;
+    occupied = other.occupied;
 }
 
 GameField& GameField::operator=(const GameField& other) {
@@ -36,7 +50,11 @@ GameField& GameField::operator=(const GameField& other) {
 
     width = other.width;
     height = other.height;
-    field = other.field;
+    copyCells(other);
+    ship_index = other.ship_index;
+    zobrist = other.zobrist;
+    ships = other.ships;
+    occupied = other.occupied;
 
     return *this;
 }
@@ -48,27 +66,93 @@ GameField& GameField::operator=(GameField&& other) noexcept {
 
     width = std::move(other.width);
     height = std::move(other.height);
-    field = std::move(other.field);
+    mode = other.mode;
+    chunk_columns = other.chunk_columns;
+    chunks = std::move(other.chunks);
+    sparse = std::move(other.sparse);
+    ship_index = std::move(other.ship_index);
+    zobrist = other.zobrist;
+    ships = other.ships;
+    occupied = other.occupied;
 
     return *this;
 }
 
+void GameField::allocate(int new_width, int new_height, FieldMode new_mode) {
+    width = new_width;
+    height = new_height;
+    mode = new_mode;
+    chunk_columns = (width + chunkSide - 1) >> chunkShift;
+    int chunk_rows = (height + chunkSide - 1) >> chunkShift;
+    chunks.clear();
+    sparse.clear();
+    ship_index = ShipSpatialIndex(width, height);
+    if (mode == FieldMode::Sparse) {
+        return;
+    }
+    chunks.resize(static_cast<std::size_t>(chunk_columns) * chunk_rows);
+    if (mode == FieldMode::Classic) {
+        for (int y = 0; y < height; y += chunkSide) {
+            for (int x = 0; x < width; x += chunkSide) {
+                cellAt({x, y}); // классическое поле целиком в памяти, как и раньше
+            }
+        }
+    }
+}
+
+void GameField::copyCells(const GameField& other) {
+    mode = other.mode;
+    chunk_columns = other.chunk_columns;
+    sparse = other.sparse;
+    chunks.clear();
+    chunks.resize(other.chunks.size());
+    for (std::size_t i = 0; i < other.chunks.size(); ++i) {
+        if (other.chunks[i]) {
+            chunks[i] = std::make_unique<Chunk>(*other.chunks[i]);
+        }
+    }
+}
+
+Cell& GameField::cellAt(Coords coords) {
+    if (mode == FieldMode::Sparse) {
+        return sparse.at(SparseCellTable<Cell>::pack(coords.x, coords.y));
+    }
+    std::unique_ptr<Chunk>& chunk = chunks[(coords.y >> chunkShift) * chunk_columns + (coords.x >> chunkShift)];
+    if (!chunk) {
+        int first_x = coords.x & ~(chunkSide - 1);
+        int first_y = coords.y & ~(chunkSide - 1);
+        chunk = std::make_unique<Chunk>();
+        chunk->width = std::min(chunkSide, width - first_x);
+        chunk->cells.resize(static_cast<std::size_t>(chunk->width) * std::min(chunkSide, height - first_y));
+    }
+    return chunk->cells[(coords.y & (chunkSide - 1)) * chunk->width + (coords.x & (chunkSide - 1))];
+}
+
+const Cell& GameField::peekCell(Coords coords) const noexcept {
+    static const Cell untouched; // клетки несозданного блока: ни корабля, ни выстрела
+    if (mode == FieldMode::Sparse) {
+        const Cell* cell = sparse.find(SparseCellTable<Cell>::pack(coords.x, coords.y));
+        return cell != nullptr ? *cell : untouched;
+    }
+    const std::unique_ptr<Chunk>& chunk = chunks[(coords.y >> chunkShift) * chunk_columns + (coords.x >> chunkShift)];
+    if (!chunk) {
+        return untouched;
+    }
+    return chunk->cells[(coords.y & (chunkSide - 1)) * chunk->width + (coords.x & (chunkSide - 1))];
+}
+
 const Cell& GameField::getCellAt(const Coords& coords) const {
     if (!coordinatsInField(coords)) {
         throw std::out_of_range("Coordinates are out of field bounds");
     }
-    return field[coords.y][coords.x];
+    return peekCell(coords);
 }
 
 Cell& GameField::getCellAt(const Coords& coords) {
     if (!coordinatsInField(coords)) {
         throw std::out_of_range("Coordinates are out of field bounds");
     }
-    return field[coords.y][coords.x];
-}
-
-std::vector<std::vector<Cell>>& GameField::getField() {
-    return field;
+    return cellAt(coords);
 }
 
 int GameField::getWidth() const {
@@ -79,6 +163,24 @@ int GameField::getHeight() const {
     return height;
 }
 
+const ShipSpatialIndex& GameField::getShipIndex() const {
+    return ship_index;
+}
+
+FieldMode GameField::getMode() const {
+    return mode;
+}
+
+std::size_t GameField::getStorageBytes() const {
+    std::size_t bytes = chunks.capacity() * sizeof(std::unique_ptr<Chunk>) + sparse.memoryBytes();
+    for (const std::unique_ptr<Chunk>& chunk : chunks) {
+        if (chunk) {
+            bytes += sizeof(Chunk) + chunk->cells.capacity() * sizeof(Cell);
+        }
+    }
+    return bytes;
+}
+
 bool GameField::coordinatsInField(Coords coords_check) const {
     if (coords_check.x < 0 || coords_check.x >= width || coords_check.y < 0 || coords_check.y >= height) {
         return false;
@@ -89,39 +191,64 @@ bool GameField::coordinatsInField(Coords coords_check) const {
 }
 
 bool GameField::shipCoordinatesCorrect(Coords top_left, Orientation orientation, int size) {
-    Coords coords_cell = top_left;
-
-    for (int i = 0; i < size; ++i) {
-        if (orientation == Orientation::Vertical) {
-            coords_cell.y = top_left.y + i;
-        } else {
-            coords_cell.x = top_left.x + i;
-        }
-
-        if (!coordinatsInField(coords_cell)) {
-            return false;
-        }
+    return shipFits(top_left, orientation, size, true);
+}
 
-        if (field[coords_cell.y][coords_cell.x].ship_is_here ||
-            field[coords_cell.y][coords_cell.x].ship_is_nearly) {
-            return false;
+bool GameField::shipFits(Coords top_left, Orientation orientation, int size, bool with_halo) const {
+    if (size < minimalShipLength || size > maximalShipLength) {
+        return false;
+    }
+    Coords last = top_left;
+    if (orientation == Orientation::Vertical) {
+        last.y += size - 1;
+    } else {
+        last.x += size - 1;
+    }
+    if (!coordinatsInField(top_left) || !coordinatsInField(last)) {
+        return false;
+    }
+    if (mode == FieldMode::Classic) {
+        return !Neighborhood::shipIntersects(with_halo ? occupied : ships, Neighborhood::area(top_left, size, orientation));
+    }
+    // Большое и разреженное поля не помещаются в битовые доски: проверяем прямоугольник корабля (с ореолом) по клеткам
+    int margin = with_halo ? 1 : 0;
+    int first_x = std::max(top_left.x - margin, 0);
+    int first_y = std::max(top_left.y - margin, 0);
+    int last_x = std::min(last.x + margin, width - 1);
+    int last_y = std::min(last.y + margin, height - 1);
+    for (int y = first_y; y <= last_y; ++y) {
+        for (int x = first_x; x <= last_x; ++x) {
+            if (peekCell({x, y}).ship_is_here) {
+                return false;
+            }
         }
     }
     return true;
 }
 
 void GameField::resizeSize(int new_width, int new_height) {
-    width = new_width;
-    height = new_height;
-    field.clear();
-    field.resize(height, std::vector<Cell>(width));
+    allocate(new_width, new_height, new_width > maximalFieldSize || new_height > maximalFieldSize ? FieldMode::Large
+                                                                                                 : FieldMode::Classic);
+    zobrist = 0;
+    ships = Bitboard();
+    occupied = Bitboard();
 }
 
 void GameField::placeShip(Ship& ship, Coords top_left, Orientation orientation) {
     if (!shipCoordinatesCorrect(top_left, orientation, ship.getLength())) {
         throw std::out_of_range("Ship coordinates out of range");
     }
+    putShip(ship, top_left, orientation);
+}
 
+void GameField::placeRestoredShip(Ship& ship, Coords top_left, Orientation orientation) {
+    if (!shipFits(top_left, orientation, ship.getLength(), false)) { // пересечение кораблей по-прежнему запрещено
+        throw std::out_of_range("Ship coordinates out of range");
+    }
+    putShip(ship, top_left, orientation);
+}
+
+void GameField::putShip(Ship& ship, Coords top_left, Orientation orientation) {
     ship.setShipCoordinates(orientation, top_left);
 
     Coords ship_cell = top_left;
@@ -131,85 +258,91 @@ void GameField::placeShip(Ship& ship, Coords top_left, Orientation orientation)
         } else {
             ship_cell.x = top_left.x + i;
         }
-        field[ship_cell.y][ship_cell.x].ship_is_here = true;
-        field[ship_cell.y][ship_cell.x].ship_segment_pointer = const_cast<Ship::ShipSegment*>(ship.getSegmentByIndex(i));
+        Cell& cell = cellAt(ship_cell);
+        cell.ship_is_here = true;
+        cell.ship_segment_pointer = const_cast<Ship::ShipSegment*>(ship.getSegmentByIndex(i));
     }
+    ship_index.add(ship);
 
-    int offset_x = (orientation == Orientation::Vertical) ? 0 : ship.getLength() - 1;
-    int offset_y = (orientation == Orientation::Vertical) ? ship.getLength() - 1 : 0;
-
-    for (int x = top_left.x - 1; x <= top_left.x + offset_x; x++) {
-        for (int y = top_left.y - 1; y <= top_left.y + offset_y; y++) {
-            if (coordinatsInField({x, y})) {
-                if (!field[y][x].ship_is_here) {
-                    field[y][x].ship_is_nearly = true;
-                }
-            }
-        }
+    if (mode != FieldMode::Classic) {
+        return; // ореол проверяется по клеткам в shipFits, в памяти остаются только клетки корабля
     }
+    // Ореол со всех сторон, включая клетки за кормой и справа от корабля
+    const ShipArea& area = Neighborhood::area(top_left, ship.getLength(), orientation);
+    Neighborhood::markShip(ships, area);
+    Neighborhood::markHalo(occupied, area, width, height);
 }
 
 void GameField::attackCell(Coords attack_coords) {
-    if (!coordinatsInField(attack_coords)) {
+    if (tryAttack(attack_coords).result == AttackResult::OutOfBounds) {
         throw std::out_of_range("Ship coordinates out of range");
     }
+}
 
-    if (field[attack_coords.y][attack_coords.x].ship_is_here) {
-        field[attack_coords.y][attack_coords.x].status_cell = Status::Ship;
-        field[attack_coords.y][attack_coords.x].ship_segment_pointer->ship_pointer->damageSegment(field[attack_coords.y][attack_coords.x].ship_segment_pointer, 1);
-    } else {
-        field[attack_coords.y][attack_coords.x].status_cell = Status::Empty;
-        field[attack_coords.y][attack_coords.x].missed = true;
+AttackOutcome GameField::tryAttack(Coords attack_coords) noexcept {
+    AttackOutcome outcome;
+    if (!coordinatsInField(attack_coords)) {
+        return outcome;
     }
+
+    Cell& cell = cellAt(attack_coords);
+    if (!cell.ship_is_here) {
+        outcome.result = cell.missed ? AttackResult::AlreadyShot : AttackResult::Miss;
+        changeStatus(cell, attack_coords, Status::Empty);
+        cell.missed = true;
+        return outcome;
+    }
+
+    Ship::ShipSegment* segment = cell.ship_segment_pointer;
+    Ship& ship = *segment->ship_pointer;
+    outcome.ship_id = ship.getId();
+    changeStatus(cell, attack_coords, Status::Ship);
+    if (segment->status == SegmentStatus::Destroyed) {
+        outcome.result = AttackResult::AlreadyShot;
+        return outcome;
+    }
+    ship.damageSegment(segment, 1);
+    outcome.result = ship.isAlive() ? AttackResult::Hit : AttackResult::Sunk;
+    return outcome;
+}
+
+const Cell* GameField::findCell(Coords coords) const noexcept {
+    return coordinatsInField(coords) ? &peekCell(coords) : nullptr;
 }
 
 void GameField::print_field() const {
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            if (field[y][x].ship_is_here == true) {
-                if (field[y][x].ship_segment_pointer->status == SegmentStatus::Damaged) {
-                    std::cout << "1";
-                }
-                if (field[y][x].ship_segment_pointer->status == SegmentStatus::Destroyed) {
-                    std::cout << "0";
-                }
-                if (field[y][x].ship_segment_pointer->status == SegmentStatus::Intact) {
-                    std::cout << "2";
-                }
-            }
-            else {
-                if (field[y][x].missed) {
-                    std::cout << "x";
-                }
-                else {
-                    std::cout << ".";
-                }
-            }
-        }
-        std::cout << "\n";
-    }
+    BoardRenderer renderer;
+    renderer.board(*this);
+    renderer.emit();
 }
 
 Status GameField::getCellStatus(const Coords& coords) const {
     if (!coordinatsInField(coords)) {
         throw std::out_of_range("Coordinates are out of field bounds");
     }
-    return field[coords.y][coords.x].status_cell;
+    return peekCell(coords).status_cell;
 }
 
 void GameField::setCellStatus(const Coords& coords, Status new_status) {
     if (!coordinatsInField(coords)) {
         throw std::out_of_range("Coordinates are out of field bounds");
     }
-    field[coords.y][coords.x].status_cell = new_status;
+    changeStatus(cellAt(coords), coords, new_status);
+}
+
+void GameField::changeStatus(Cell& cell, Coords coords, Status new_status) {
+    zobrist ^= Zobrist::cell(coords.x, coords.y, static_cast<int>(cell.status_cell));
+    zobrist ^= Zobrist::cell(coords.x, coords.y, static_cast<int>(new_status));
+    cell.status_cell = new_status;
 }
 
 bool GameField::isShipHereDestroyed(const Coords& coords) {
     if (!coordinatsInField(coords)) {
         throw std::out_of_range("Coordinates are out of field bounds");
     }
-    if (field[coords.y][coords.x].ship_is_here && field[coords.y][coords.x].ship_segment_pointer) {
-        return field[coords.y][coords.x].ship_segment_pointer->status == SegmentStatus::Destroyed;
+    const Cell& cell = peekCell(coords);
+    if (cell.ship_is_here && cell.ship_segment_pointer) {
+        return cell.ship_segment_pointer->status == SegmentStatus::Destroyed;
     }
     return false;
 }
@@ -218,5 +351,9 @@ bool GameField::isShipHere(const Coords& coords) {
     if (!coordinatsInField(coords)) {
         throw std::out_of_range("Coordinates are out of field bounds");
     }
-    return field[coords.y][coords.x].ship_is_here;
+    return peekCell(coords).ship_is_here;
+}
+
+std::uint64_t GameField::getHash() const {
+    return zobrist;
 }
@@ -1,54 +1,61 @@
 #include "GameState.h"
 #include <iostream>
 #include "FileExeption.h"
-
-GameState::GameState(Game& game) : current_state() {
-    // Основные параметры
-    current_state["round_counter"] = game.getRoundCounter();
-    current_state["is_player_step"] = game.getIsPlayerStep();
-    current_state["is_player_use_ability"] = game.getIsPlayerUseAbility();
-    current_state["is_player_do_attack"] = game.getIsPlayerDoAttack();
-
-    // Параметры полей
-    const GameField& playerField = game.getPlayerField();
-    const GameField& enemyField = game.getEnemyField();
-
-    current_state["player_field_width"] = playerField.getWidth();
-    current_state["player_field_height"] = playerField.getHeight();
-    current_state["player_field"] = saveFieldToJson(playerField);
-    current_state["bot_field_width"] = enemyField.getWidth();
-    current_state["bot_field_height"] = enemyField.getHeight();
-    current_state["bot_field"] = saveFieldToJson(enemyField);
-
-    // Управление кораблями
-    current_state["player_ship_data"] = saveShipsToJson(game.getPlayerShipManager());
-    current_state["bot_ship_data"] = saveShipsToJson(game.getEnemyShipManager());
-
-    // Управление способностями
-    current_state["player_ability_manager"] = saveAbilityManagerToJson(game.getPlayerAbilitiesManager());
+#include "BinarySave.h"
+#include "SaveSaxLoader.h"
+#include "JsonSaveWriter.h"
+#include "SaveJournal.h"
+#include "FieldCodec.h"
+
+GameState::GameState(Game& game, SaveFormat format) : current_state(), format(format) {
+    if (format == SaveFormat::Binary || format == SaveFormat::Journal) {
+        image = SaveImage::capture(game);
+        has_image = true;
+        return;
+    }
+    this->format = SaveFormat::Json;
+    // Текст пишется сразу из объектов игры; дерево json строится, только если его запросят
+    JsonSaveWriter writer;
+    writer.write(game);
+    text = writer.release();
 }
 
 GameState::GameState(const string& file_name) {
     try {
         FileHandler file_handler(file_name);
         file_handler.openForRead();
-        file_handler.read(current_state);
+        vector<uint8_t> data;
+        file_handler.readBytes(data);
         file_handler.closeRead();
+        // Формат определяется по сигнатуре, а не по расширению. JSON читается потоково, без дерева json
+        if (BinarySave::isBinary(data)) {
+            format = SaveFormat::Binary;
+            image = BinarySave::decode(data);
+        } else if (SaveJournal::isJournal(data)) {
+            format = SaveFormat::Journal;
+            Game replayed = SaveJournal::replay(data);
+            image = SaveImage::capture(replayed);
+        } else {
+            image = SaveSaxLoader::parse(data);
+        }
+        has_image = true;
     } catch (const FileExeption& e) {
         cerr << "Error while loading game state: " << e.what() << endl;
     }
 }
 
+// Поле сохраняется строкой FieldCodec; загрузка понимает и старый вид - массив строк
 json GameState::saveFieldToJson(const GameField& field) {
-    json field_json = json::array();
+    vector<Status> cells;
+    cells.reserve(field.getWidth() * field.getHeight());
     for (int y = 0; y < field.getHeight(); ++y) {
-        json row = json::array();
         for (int x = 0; x < field.getWidth(); ++x) {
-            row.push_back(static_cast<int>(field.getCellStatus({x, y})));
+            cells.push_back(field.getCellStatus({x, y}));
         }
-        field_json.push_back(row);
     }
-    return field_json;
+    string packed;
+    FieldCodec::encodeText(cells.data(), cells.size(), packed);
+    return packed;
 }
 
 
@@ -81,11 +88,37 @@ json GameState::saveAbilityManagerToJson(const AbilityManager& ability_manager)
     return abilities_json;
 }
 
+const string& GameState::jsonText() {
+    if (text.empty()) {
+        if (has_image) {
+            JsonSaveWriter writer;
+            writer.write(image);
+            text = writer.release();
+        } else {
+            text = current_state.dump(4);
+        }
+    }
+    return text;
+}
+
+json& GameState::tree() {
+    if (current_state.is_null() && (has_image || !text.empty())) {
+        current_state = json::parse(jsonText());
+    }
+    return current_state;
+}
+
 bool GameState::save(const string& file_name) {
     try {
         FileHandler file_handler(file_name);
         file_handler.openForWrite();
-        file_handler.write(current_state);
+        if (format == SaveFormat::Binary && has_image) {
+            file_handler.writeBytes(BinarySave::encode(image));
+        } else if (format == SaveFormat::Journal && has_image) {
+            file_handler.writeBytes(SaveJournal::snapshot(image)); // журнал из одного снимка
+        } else {
+            file_handler.writeText(jsonText());
+        }
         file_handler.closeWrite();
         return true;
     } catch (const FileExeption& e) {
@@ -94,114 +127,126 @@ bool GameState::save(const string& file_name) {
     return false;
 }
 
-GameField GameState::loadFieldFromJson(int width, int height, json& field_data) {
-    GameField field(width, height);
-    for (int y = 0; y < field_data.size(); ++y) {
-        for (int x = 0; x < field_data[y].size(); ++x) {
-            Status cellStatus = static_cast<Status>(field_data[y][x].get<int>());
-            field.setCellStatus({x, y}, cellStatus);
-
-            // Если ячейка имеет статус 1, помечаем её как промах
-            if (cellStatus == Status::Empty) {
-                field.getCellAt({x, y}).missed = true;
-            }
-        }
+bool GameState::saveText(const string& file_name, const string& json_text) {
+    try {
+        FileHandler file_handler(file_name);
+        file_handler.openForWrite();
+        file_handler.writeText(json_text);
+        file_handler.closeWrite();
+        return true;
+    } catch (const FileExeption& e) {
+        cerr << "Error while saving game state: " << e.what() << endl;
     }
-    return field;
+    return false;
 }
 
+SaveFormat GameState::formatForFile(const string& file_name) {
+    auto ends_with = [&](const string& extension) {
+        return file_name.size() >= extension.size() &&
+               file_name.compare(file_name.size() - extension.size(), extension.size(), extension) == 0;
+    };
+    if (ends_with(".bin")) {
+        return SaveFormat::Binary;
+    }
+    if (ends_with(".journal")) {
+        return SaveFormat::Journal;
+    }
+    return SaveFormat::Json;
+}
 
-ShipManager GameState::loadShipManagerFromJson(json& ships_data, GameField& field) {
-    vector<int> ship_sizes;
+void GameState::readFieldImage(int width, int height, json& field_data, SaveImage::SideImage& side) {
+    side.width = width;
+    side.height = height;
+    side.cells.assign(width * height, Status::Unknown);
+    if (field_data.is_string()) {
+        FieldCodec::decodeText(field_data.get_ref<const string&>(), side.cells.data(), side.cells.size());
+        return;
+    }
+    for (int y = 0; y < field_data.size() && y < height; ++y) {
+        for (int x = 0; x < field_data[y].size() && x < width; ++x) {
+            side.cells[y * width + x] = static_cast<Status>(field_data[y][x].get<int>());
+        }
+    }
+}
 
-    // Сначала собираем размеры кораблей
+void GameState::readShipsImage(json& ships_data, SaveImage::SideImage& side) {
+    side.ships.clear();
     for (const auto& ship_data : ships_data) {
         if (!ship_data.contains("coords") || !ship_data.contains("orientation") || !ship_data.contains("segments")) {
             throw std::runtime_error("Invalid ship data format");
         }
-        ship_sizes.push_back(ship_data["segments"].size());
-    }
-
-    ShipManager ship_manager(ship_sizes);
-
-    // Теперь размещаем корабли
-    for (int i = 0; i < ships_data.size(); ++i) {
-        const auto& ship_data = ships_data[i];
-        Ship& ship = ship_manager.getFreeShip(0); // Всегда берём первый свободный корабль
-
-        // Получаем координаты и ориентацию
-        Coords coords = {ship_data["coords"][0].get<int>(), ship_data["coords"][1].get<int>()};
-        Orientation orientation = static_cast<Orientation>(ship_data["orientation"].get<int>()); 
-
-        // Размещаем корабль на поле
-        field.placeShip(ship, coords, orientation);
-
-        // Перемещаем корабль в активные
-        ship_manager.moveShipToActive(0);
-
-        // Проходим по сегментам корабля и наносим урон в соответствии со статусом
-        const auto& segments_data = ship_data["segments"];
-        for (size_t j = 0; j < segments_data.size(); ++j) {
-            SegmentStatus segment_status = static_cast<SegmentStatus>(segments_data[j]["status"].get<int>());
-
-            // Вычисляем координаты сегмента на поле
-            Coords segment_coords = coords;
-            if (orientation == Orientation::Horizontal) {
-                segment_coords.x += j;
-            } else {
-                segment_coords.y += j;
-            }
-
-            // Наносим урон в соответствии со статусом сегмента
-            if (segment_status == SegmentStatus::Damaged) {
-                field.attackCell(segment_coords);
-            }
-            if (segment_status == SegmentStatus::Destroyed) {
-                field.attackCell(segment_coords);
-                field.attackCell(segment_coords);
-            }
+        SaveImage::ShipImage ship;
+        ship.coords = {ship_data["coords"][0].get<int>(), ship_data["coords"][1].get<int>()};
+        ship.orientation = static_cast<Orientation>(ship_data["orientation"].get<int>());
+        for (const auto& segment_data : ship_data["segments"]) {
+            ship.segments.push_back(static_cast<SegmentStatus>(segment_data["status"].get<int>()));
         }
+        side.ships.push_back(std::move(ship));
     }
-
-    return ship_manager;
 }
 
-AbilityManager GameState::loadAbilityManagerFromJson(json& ability_data) {
-    deque<unique_ptr<Ability>> abilities;
+void GameState::readAbilitiesImage(json& ability_data, SaveImage::SideImage& side) {
+    side.abilities.clear();
     for (const auto& ability_name : ability_data) {
         if (ability_name == "DoubleDamage") {
-            abilities.push_back(make_unique<DoubleDamage>());
+            side.abilities.push_back(AbilityKind::DoubleDamage);
         } else if (ability_name == "Scanner") {
-            abilities.push_back(make_unique<Scanner>());
+            side.abilities.push_back(AbilityKind::Scanner);
         } else if (ability_name == "Bombardment") {
-            abilities.push_back(make_unique<Bombardment>());
+            side.abilities.push_back(AbilityKind::Bombardment);
         } else {
             throw runtime_error("Unknown ability name in JSON");
         }
     }
-    return AbilityManager(std::move(abilities)); 
 }
 
-Game GameState::load() {
-    int round = current_state["round_counter"].get<int>();
-    bool is_player_step = current_state["is_player_step"].get<bool>();
-    bool is_player_use_ability = current_state["is_player_use_ability"].get<bool>();
-    bool is_player_do_attack = current_state["is_player_do_attack"].get<bool>();
+GameField GameState::loadFieldFromJson(int width, int height, json& field_data) {
+    SaveImage::SideImage side;
+    readFieldImage(width, height, field_data, side);
+    return SaveImage::restoreField(side);
+}
+
+ShipManager GameState::loadShipManagerFromJson(json& ships_data, GameField& field) {
+    SaveImage::SideImage side;
+    readShipsImage(ships_data, side);
+    return SaveImage::restoreShips(side, field);
+}
+
+AbilityManager GameState::loadAbilityManagerFromJson(json& ability_data) {
+    SaveImage::SideImage side;
+    readAbilitiesImage(ability_data, side);
+    return SaveImage::restoreAbilities(side);
+}
 
-    int player_field_width = current_state["player_field_width"].get<int>();
-    int player_field_height = current_state["player_field_height"].get<int>();
-    GameField player_field = loadFieldFromJson(player_field_width, player_field_height, current_state["player_field"]);
-    ShipManager player_ship_manager = loadShipManagerFromJson(current_state["player_ship_data"], player_field);
-    AbilityManager player_ability_manager = loadAbilityManagerFromJson(current_state["player_ability_manager"]);
+Game GameState::load() {
+    if (has_image) {
+        return image.restore();
+    }
+    if (!text.empty()) {
+        return SaveSaxLoader::parse(text).restore();
+    }
 
-    int bot_field_width = current_state["bot_field_width"].get<int>();
-    int bot_field_height = current_state["bot_field_height"].get<int>();
-    GameField bot_field = loadFieldFromJson(bot_field_width, bot_field_height, current_state["bot_field"]);
-    ShipManager bot_ship_manager = loadShipManagerFromJson(current_state["bot_ship_data"], bot_field);
+    // JSON разбирается в SaveImage, дальше восстановление общее с двоичным форматом
+    SaveImage loaded;
+    loaded.round_counter = current_state["round_counter"].get<int>();
+    loaded.is_player_step = current_state["is_player_step"].get<bool>();
+    loaded.is_player_use_ability = current_state["is_player_use_ability"].get<bool>();
+    loaded.is_player_do_attack = current_state["is_player_do_attack"].get<bool>();
+
+    readFieldImage(current_state["player_field_width"].get<int>(), current_state["player_field_height"].get<int>(),
+                   current_state["player_field"], loaded.player);
+    readShipsImage(current_state["player_ship_data"], loaded.player);
+    readAbilitiesImage(current_state["player_ability_manager"], loaded.player);
+
+    readFieldImage(current_state["bot_field_width"].get<int>(), current_state["bot_field_height"].get<int>(),
+                   current_state["bot_field"], loaded.bot);
+    readShipsImage(current_state["bot_ship_data"], loaded.bot);
+    // В старых сохранениях у бота нет способностей
+    if (current_state.contains("bot_ability_manager")) {
+        readAbilitiesImage(current_state["bot_ability_manager"], loaded.bot);
+    }
 
-    // Создаём и возвращаем игру напрямую
-    return Game(std::move(player_field), std::move(bot_field), std::move(player_ship_manager), std::move(bot_ship_manager),
-                std::move(player_ability_manager), round, is_player_step, is_player_use_ability, is_player_do_attack);
+    return loaded.restore();
 }
 
 
@@ -209,7 +254,7 @@ Game GameState::load() {
 
 
 ostream& operator<<(ostream& os, GameState& state) {
-    os << state.current_state.dump(4) << "\n";
+    os << state.jsonText() << "\n";
     return os;
 }
 
@@ -217,5 +262,8 @@ istream& operator>>(istream& is, GameState& state) {
     json input_data;
     is >> input_data;
     state.current_state = input_data;
+    state.text.clear();
+    state.has_image = false;
+    state.format = SaveFormat::Json;
     return is;
 }
\ No newline at end of file
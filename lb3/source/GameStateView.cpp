@@ -0,0 +1,112 @@
+#include "GameStateView.h"
+#include "FileHandler.h"
+#include "BinarySave.h"
+#include "SaveJournal.h"
+#include "SaveSaxLoader.h"
+
+GameStateView::GameStateView(const std::string& file_name) {
+    FileHandler file_handler(file_name);
+    file_handler.openForRead();
+    file_handler.readBytes(data);
+    file_handler.closeRead();
+    if (BinarySave::isBinary(data)) {
+        format = SaveFormat::Binary;
+    } else if (SaveJournal::isJournal(data)) {
+        format = SaveFormat::Journal;
+    }
+}
+
+void GameStateView::loadHeader() {
+    if (has_header) {
+        return;
+    }
+    SaveImage header;
+    if (format == SaveFormat::Json) {
+        header = SaveSaxLoader::parse(data, SaveSaxLoader::Header);
+    } else if (format == SaveFormat::Binary) {
+        header = BinarySave::decodeHeader(data.data(), data.size());
+    } else {
+        loadSides(SaveSaxLoader::AllSections); // журнал без воспроизведения не прочитать
+        return;
+    }
+    image.round_counter = header.round_counter;
+    image.is_player_step = header.is_player_step;
+    image.is_player_use_ability = header.is_player_use_ability;
+    image.is_player_do_attack = header.is_player_do_attack;
+    has_header = true;
+}
+
+void GameStateView::loadSides(unsigned wanted) {
+    unsigned missing = wanted & ~sides;
+    if (missing == 0) {
+        return;
+    }
+    if (format == SaveFormat::Json) {
+        SaveImage parsed = SaveSaxLoader::parse(data, missing);
+        if ((sides & SaveSaxLoader::PlayerSide) != 0) {
+            parsed.player = std::move(image.player); // уже разобранная сторона не читается заново
+        }
+        if ((sides & SaveSaxLoader::BotSide) != 0) {
+            parsed.bot = std::move(image.bot);
+        }
+        image = std::move(parsed);
+    } else if (format == SaveFormat::Binary) {
+        image = BinarySave::decode(data);
+        missing = SaveSaxLoader::AllSections;
+    } else {
+        Game replayed = SaveJournal::replay(data);
+        image = SaveImage::capture(replayed);
+        missing = SaveSaxLoader::AllSections;
+    }
+    sides |= missing;
+    has_header = true;
+}
+
+int GameStateView::getRoundCounter() {
+    loadHeader();
+    return image.round_counter;
+}
+
+bool GameStateView::getIsPlayerStep() {
+    loadHeader();
+    return image.is_player_step;
+}
+
+bool GameStateView::getIsPlayerUseAbility() {
+    loadHeader();
+    return image.is_player_use_ability;
+}
+
+bool GameStateView::getIsPlayerDoAttack() {
+    loadHeader();
+    return image.is_player_do_attack;
+}
+
+const SaveImage::SideImage& GameStateView::getPlayerSide() {
+    loadSides(SaveSaxLoader::PlayerSide);
+    return image.player;
+}
+
+const SaveImage::SideImage& GameStateView::getBotSide() {
+    loadSides(SaveSaxLoader::BotSide);
+    return image.bot;
+}
+
+int GameStateView::getAliveShips(bool player_side) {
+    const SaveImage::SideImage& side = player_side ? getPlayerSide() : getBotSide();
+    int alive = 0;
+    for (const SaveImage::ShipImage& ship : side.ships) {
+        for (SegmentStatus status : ship.segments) {
+            if (status != SegmentStatus::Destroyed) {
+                ++alive;
+                break;
+            }
+        }
+    }
+    return alive;
+}
+
+Game GameStateView::load() {
+    loadSides(SaveSaxLoader::AllSections);
+    return image.restore();
+}
@@ -0,0 +1,244 @@
+#include "JsonSaveWriter.h"
+#include "Game.h"
+#include "FieldCodec.h"
+
+constexpr int indentWidth = 4;
+
+JsonSaveWriter::JsonSaveWriter(bool pretty) : pretty(pretty) {}
+
+void JsonSaveWriter::setPretty(bool new_pretty) {
+    pretty = new_pretty;
+}
+
+const std::string& JsonSaveWriter::getBuffer() const {
+    return buffer;
+}
+
+std::string JsonSaveWriter::release() {
+    std::string text;
+    text.swap(buffer);
+    return text;
+}
+
+void JsonSaveWriter::newline() {
+    if (pretty) {
+        buffer += '\n';
+        buffer.append(first.size() * indentWidth, ' ');
+    }
+}
+
+void JsonSaveWriter::separator() {
+    if (first.empty()) {
+        return;
+    }
+    if (!first.back()) {
+        buffer += ',';
+    }
+    first.back() = false;
+    newline();
+}
+
+void JsonSaveWriter::open(char bracket) {
+    buffer += bracket;
+    first.push_back(true);
+}
+
+void JsonSaveWriter::close(char bracket) {
+    bool empty = first.back();
+    first.pop_back();
+    if (!empty) {
+        newline();
+    }
+    buffer += bracket;
+}
+
+void JsonSaveWriter::key(const char* name) {
+    separator();
+    buffer += '"';
+    buffer += name;
+    buffer += pretty ? "\": " : "\":";
+}
+
+void JsonSaveWriter::value(int number) {
+    char digits[16];
+    int length = 0;
+    unsigned magnitude = number < 0 ? 0u - static_cast<unsigned>(number) : static_cast<unsigned>(number);
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (number < 0) {
+        buffer += '-';
+    }
+    while (length > 0) {
+        buffer += digits[--length];
+    }
+}
+
+void JsonSaveWriter::value(bool flag) {
+    buffer += flag ? "true" : "false";
+}
+
+void JsonSaveWriter::value(const char* text) {
+    buffer += '"';
+    buffer += text; // имена способностей не содержат символов, требующих экранирования
+    buffer += '"';
+}
+
+void JsonSaveWriter::field(const Status* cells, int count) {
+    buffer += '"';
+    FieldCodec::encodeText(cells, count, buffer);
+    buffer += '"';
+}
+
+void JsonSaveWriter::header(int round, bool player_step, bool use_ability, bool do_attack,
+                            int player_width, int player_height, int bot_width, int bot_height) {
+    buffer.clear();
+    first.clear();
+    open('{');
+    key("round_counter");
+    value(round);
+    key("is_player_step");
+    value(player_step);
+    key("is_player_use_ability");
+    value(use_ability);
+    key("is_player_do_attack");
+    value(do_attack);
+    key("player_field_width");
+    value(player_width);
+    key("player_field_height");
+    value(player_height);
+    key("bot_field_width");
+    value(bot_width);
+    key("bot_field_height");
+    value(bot_height);
+}
+
+void JsonSaveWriter::ships(const ShipManager& manager) {
+    open('[');
+    for (int i = 0; i < manager.getShipCount(); ++i) {
+        const Ship& ship = manager.getActiveShip(i);
+        separator();
+        open('{');
+        key("coords");
+        open('[');
+        separator();
+        value(ship.getCoords().x);
+        separator();
+        value(ship.getCoords().y);
+        close(']');
+        key("orientation");
+        value(static_cast<int>(ship.getOrientation()));
+        key("segments");
+        open('[');
+        for (int j = 0; j < ship.getLength(); ++j) {
+            separator();
+            open('{');
+            key("status");
+            value(static_cast<int>(ship.getSegmentByIndex(j)->getStatus()));
+            close('}');
+        }
+        close(']');
+        close('}');
+    }
+    close(']');
+}
+
+void JsonSaveWriter::ships(const std::vector<SaveImage::ShipImage>& ships) {
+    open('[');
+    for (const SaveImage::ShipImage& ship : ships) {
+        separator();
+        open('{');
+        key("coords");
+        open('[');
+        separator();
+        value(ship.coords.x);
+        separator();
+        value(ship.coords.y);
+        close(']');
+        key("orientation");
+        value(static_cast<int>(ship.orientation));
+        key("segments");
+        open('[');
+        for (SegmentStatus status : ship.segments) {
+            separator();
+            open('{');
+            key("status");
+            value(static_cast<int>(status));
+            close('}');
+        }
+        close(']');
+        close('}');
+    }
+    close(']');
+}
+
+void JsonSaveWriter::abilities(const std::vector<AbilityKind>& kinds) {
+    open('[');
+    for (AbilityKind kind : kinds) {
+        separator();
+        value(abilityKindName(kind));
+    }
+    close(']');
+}
+
+void JsonSaveWriter::abilities(const AbilityManager& manager) {
+    open('[');
+    for (const auto& ability : manager.getQueue()) {
+        separator();
+        value(abilityKindName(ability->getKind()));
+    }
+    close(']');
+}
+
+const std::string& JsonSaveWriter::write(Game& game) {
+    const GameField& player_field = game.getPlayerField();
+    const GameField& bot_field = game.getEnemyField();
+    header(game.getRoundCounter(), game.getIsPlayerStep(), game.getIsPlayerUseAbility(), game.getIsPlayerDoAttack(),
+           player_field.getWidth(), player_field.getHeight(), bot_field.getWidth(), bot_field.getHeight());
+    key("player_field");
+    cells.clear();
+    for (int y = 0; y < player_field.getHeight(); ++y) {
+        for (int x = 0; x < player_field.getWidth(); ++x) {
+            cells.push_back(player_field.getCellStatus({x, y}));
+        }
+    }
+    field(cells.data(), cells.size());
+    key("bot_field");
+    cells.clear();
+    for (int y = 0; y < bot_field.getHeight(); ++y) {
+        for (int x = 0; x < bot_field.getWidth(); ++x) {
+            cells.push_back(bot_field.getCellStatus({x, y}));
+        }
+    }
+    field(cells.data(), cells.size());
+    key("player_ship_data");
+    ships(game.getPlayerShipManager());
+    key("bot_ship_data");
+    ships(game.getEnemyShipManager());
+    key("player_ability_manager");
+    abilities(game.getPlayerAbilitiesManager());
+    key("bot_ability_manager");
+    abilities(game.getEnemyAbilitiesManager());
+    close('}');
+    return buffer;
+}
+
+const std::string& JsonSaveWriter::write(const SaveImage& image) {
+    header(image.round_counter, image.is_player_step, image.is_player_use_ability, image.is_player_do_attack,
+           image.player.width, image.player.height, image.bot.width, image.bot.height);
+    key("player_field");
+    field(image.player.cells.data(), image.player.cells.size());
+    key("bot_field");
+    field(image.bot.cells.data(), image.bot.cells.size());
+    key("player_ship_data");
+    ships(image.player.ships);
+    key("bot_ship_data");
+    ships(image.bot.ships);
+    key("player_ability_manager");
+    abilities(image.player.abilities);
+    key("bot_ability_manager");
+    abilities(image.bot.abilities);
+    close('}');
+    return buffer;
+}
@@ -0,0 +1,63 @@
+#include "LiveSegmentIndex.h"
+#include "Zobrist.h"
+#include <cstdlib>
+
+void LiveSegmentIndex::add(Ship::ShipSegment* segment) {
+    if (segment == nullptr || segment->live_slot != -1) {
+        return;
+    }
+    segment->live_slot = segments.size();
+    segments.push_back(segment);
+}
+
+void LiveSegmentIndex::remove(Ship::ShipSegment* segment) {
+    if (segment == nullptr || segment->live_slot == -1) {
+        return;
+    }
+    int slot = segment->live_slot;
+    Ship::ShipSegment* last = segments.back();
+    segments[slot] = last;
+    last->live_slot = slot;
+    segments.pop_back();
+    segment->live_slot = -1;
+}
+
+Ship::ShipSegment* LiveSegmentIndex::get(int slot) const {
+    return segments[slot];
+}
+
+Ship::ShipSegment* LiveSegmentIndex::getRandom() const {
+    if (segments.empty()) {
+        return nullptr;
+    }
+    return segments[rand() % segments.size()];
+}
+
+int LiveSegmentIndex::size() const {
+    return segments.size();
+}
+
+bool LiveSegmentIndex::empty() const {
+    return segments.empty();
+}
+
+void LiveSegmentIndex::segmentChanged(Ship::ShipSegment* segment, SegmentStatus old_status) {
+    hash ^= Zobrist::segment(segment->coords.x, segment->coords.y, static_cast<int>(old_status));
+    hash ^= Zobrist::segment(segment->coords.x, segment->coords.y, static_cast<int>(segment->status));
+    if (segment->status == SegmentStatus::Destroyed) {
+        remove(segment);
+    }
+}
+
+void LiveSegmentIndex::shipSunk(const Ship& ship) {
+    hash ^= Zobrist::sunkShip(ship.getCoords().x, ship.getCoords().y);
+    ++sunk;
+}
+
+int LiveSegmentIndex::getSunkCount() const {
+    return sunk;
+}
+
+std::uint64_t LiveSegmentIndex::getHash() const {
+    return hash;
+}
@@ -0,0 +1,680 @@
+#include "MctsAI.h"
+#include "EnemyAI.h"
+#include "ProbabilityMap.h"
+#include "Zobrist.h"
+#include "Neighborhood.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+constexpr double explorationConstant = 0.15;
+constexpr double priorConstant = 2.0; // вес карты вероятностей при выборе действия в корне (PUCT)
+constexpr int determinizationAttempts = 16;
+constexpr int failedWorldLimit = 8; // столько неудачных determinize подряд - поиск прекращается
+constexpr double coverWeight = 40.0; // положения через известные клетки кораблей предпочтительнее
+constexpr double wideningFactor = 1.5; // узел с n посещениями раскрывает не больше 1 + 1.5 * sqrt(n) действий
+constexpr int reuseIterations = 2000; // результат из кэша принимается, если его подтвердило не меньше симуляций
+constexpr std::size_t cacheEntries = 1 << 16;
+
+NodePool::NodePool(int capacity) : capacity(capacity) {
+    nodes.reserve(capacity);
+}
+
+int NodePool::allocate() {
+    if (full()) {
+        return -1;
+    }
+    nodes.emplace_back();
+    return nodes.size() - 1;
+}
+
+bool NodePool::full() const {
+    return static_cast<int>(nodes.size()) >= capacity;
+}
+
+int NodePool::size() const {
+    return nodes.size();
+}
+
+MctsNode& NodePool::operator[](int index) {
+    return nodes[index];
+}
+
+const MctsNode& NodePool::operator[](int index) const {
+    return nodes[index];
+}
+
+MctsAI::MctsAI(int threads, std::chrono::milliseconds budget, int pool_capacity)
+    : threads(threads), budget(budget), pool_capacity(pool_capacity) {}
+
+void MctsAI::setBudget(std::chrono::milliseconds new_budget) {
+    budget = new_budget;
+}
+
+void MctsAI::setThreads(int new_threads) {
+    threads = new_threads;
+}
+
+MctsAI::Root MctsAI::observe(const GameField& field, ShipManager& manager, const std::vector<std::int8_t>& scanned,
+                             const std::vector<AbilityKind>& queue, std::uint64_t observation_key) const {
+    Root root;
+    root.width = field.getWidth();
+    root.height = field.getHeight();
+    int cells = root.width * root.height;
+    root.seen.assign(cells, MctsWorld::Unknown);
+    root.known_hp.assign(cells, -1);
+    root.open.assign(cells, 1);
+    root.queue = queue;
+
+    std::vector<CellKnowledge> knowledge = ProbabilityMap::observe(field, scanned);
+    for (int i = 0; i < cells; ++i) {
+        const Cell& cell = field.getCellAt({i % root.width, i / root.width});
+        if (knowledge[i] == CellKnowledge::Blocked) {
+            root.seen[i] = MctsWorld::Closed;
+            root.open[i] = 0;
+        } else if (knowledge[i] == CellKnowledge::KnownShip) {
+            root.must_cover.push_back(i);
+            root.seen[i] = MctsWorld::KnownShip;
+            if (cell.status_cell == Status::Ship && cell.ship_segment_pointer != nullptr) {
+                SegmentStatus status = cell.ship_segment_pointer->status;
+                root.known_hp[i] = status == SegmentStatus::Intact ? 2 : (status == SegmentStatus::Damaged ? 1 : 0);
+                if (root.known_hp[i] == 1) {
+                    root.seen[i] = MctsWorld::HitDamaged;
+                } else if (root.known_hp[i] == 0) {
+                    root.seen[i] = MctsWorld::HitDone;
+                }
+            }
+        }
+    }
+
+    root.lengths = EnemyAI::remainingLengths(manager);
+    std::sort(root.lengths.rbegin(), root.lengths.rend());
+    for (int length : root.lengths) {
+        root.total_hp += length * 2;
+    }
+    for (int cell : root.must_cover) {
+        if (root.known_hp[cell] >= 0) {
+            root.total_hp -= 2 - root.known_hp[cell];
+        }
+    }
+    root.total_hp = std::max(root.total_hp, 1);
+
+    // Корневые действия раскрываются в порядке их ценности по карте вероятностей,
+    // той же, что использует EnemyAI: урон для выстрелов и DoubleDamage, информация для сканера
+    ProbabilityMap map = ProbabilityMap::cached(observation_key, field, root.lengths, scanned);
+    root.prior.assign(cells * 2, 0.0);
+    for (int cell = 0; cell < cells; ++cell) {
+        Coords coords = {cell % root.width, cell / root.width};
+        root.prior[cell] = root.seen[cell] == MctsWorld::HitDamaged ? 1.0 : map.at(coords);
+        root.prior[cells + cell] = 2.0 * map.at(coords);
+        if (!queue.empty() && queue.front() == AbilityKind::Scanner) {
+            double information = 0.0;
+            for (int sy = coords.y; sy < coords.y + 2 && sy < root.height; ++sy) {
+                for (int sx = coords.x; sx < coords.x + 2 && sx < root.width; ++sx) {
+                    if (root.seen[sy * root.width + sx] == MctsWorld::Unknown) {
+                        information += EnemyAI::entropy(map.at({sx, sy}));
+                    }
+                }
+            }
+            root.prior[cells + cell] = information;
+        }
+    }
+    if (!queue.empty() && queue.front() == AbilityKind::Bombardment) {
+        root.prior[cells] = 1.0;
+    }
+    return root;
+}
+
+bool MctsAI::determinize(const Root& root, MctsWorld& world, std::mt19937_64& rng) const {
+    int cells = root.width * root.height;
+    world.width = root.width;
+    world.height = root.height;
+    world.seen = root.seen;
+    world.queue = root.queue;
+    world.queue_head = 0;
+    world.turns = 0;
+    world.ability_used = false;
+
+    std::vector<std::uint8_t> must(cells, 0);
+    for (int cell : root.must_cover) {
+        must[cell] = 1;
+    }
+
+    std::vector<std::uint8_t> taken(cells);
+    std::vector<int> starts;
+    std::vector<double> weights;
+    bool placed = false;
+    bool covered = false;
+
+    for (int attempt = 0; attempt < determinizationAttempts; ++attempt) {
+        world.ship.assign(cells, -1);
+        world.ship_cells.assign(root.lengths.size(), {});
+        std::fill(taken.begin(), taken.end(), 0);
+        placed = true;
+
+        for (int k = 0; k < static_cast<int>(root.lengths.size()); ++k) {
+            int length = root.lengths[k];
+            starts.clear();
+            weights.clear();
+            double total = 0.0;
+            for (int vertical = 0; vertical < (length == 1 ? 1 : 2); ++vertical) {
+                int dx = vertical ? 0 : 1;
+                int dy = vertical ? 1 : 0;
+                for (int y = 0; y < root.height - dy * (length - 1); ++y) {
+                    for (int x = 0; x < root.width - dx * (length - 1); ++x) {
+                        double weight = 1.0;
+                        bool possible = true;
+                        for (int i = 0; i < length && possible; ++i) {
+                            int cell = (y + dy * i) * root.width + x + dx * i;
+                            possible = root.open[cell] && !taken[cell];
+                            if (must[cell] && world.ship[cell] < 0) {
+                                weight *= coverWeight;
+                            }
+                        }
+                        if (possible) {
+                            starts.push_back((y * root.width + x) * 2 + vertical);
+                            weights.push_back(weight);
+                            total += weight;
+                        }
+                    }
+                }
+            }
+            if (starts.empty()) {
+                placed = false;
+                break;
+            }
+
+            double pick = std::uniform_real_distribution<double>(0.0, total)(rng);
+            int chosen = 0;
+            while (chosen + 1 < static_cast<int>(starts.size()) && pick >= weights[chosen]) {
+                pick -= weights[chosen++];
+            }
+            int vertical = starts[chosen] % 2;
+            int x0 = (starts[chosen] / 2) % root.width;
+            int y0 = (starts[chosen] / 2) / root.width;
+            for (int i = 0; i < length; ++i) {
+                int x = x0 + (vertical ? 0 : i);
+                int y = y0 + (vertical ? i : 0);
+                world.ship[y * root.width + x] = k;
+                world.ship_cells[k].push_back(y * root.width + x);
+            }
+            const ShipArea& area =
+                Neighborhood::area({x0, y0}, length, vertical ? Orientation::Vertical : Orientation::Horizontal);
+            Neighborhood::forEachHaloCell(area, root.width, root.height,
+                                          [&](Coords coords) { taken[coords.y * root.width + coords.x] = 1; });
+        }
+
+        if (!placed) {
+            continue;
+        }
+        covered = true;
+        for (int cell : root.must_cover) {
+            covered = covered && world.ship[cell] >= 0;
+        }
+        if (covered) {
+            break;
+        }
+    }
+    if (!placed || !covered) {
+        return false; // мир противоречит известным попаданиям - итерация отбрасывается
+    }
+
+    world.hp.assign(cells, 0);
+    world.ship_hp.assign(root.lengths.size(), 0);
+    world.alive_ships = 0;
+    for (int k = 0; k < static_cast<int>(world.ship_cells.size()); ++k) {
+        for (int cell : world.ship_cells[k]) {
+            world.hp[cell] = root.known_hp[cell] >= 0 ? root.known_hp[cell] : 2;
+            world.ship_hp[k] += world.hp[cell];
+        }
+        if (world.ship_hp[k] > 0) {
+            ++world.alive_ships;
+        }
+    }
+    return true;
+}
+
+void MctsAI::legalActions(const MctsWorld& world, bool ability_phase, std::vector<int>& actions) {
+    int cells = world.width * world.height;
+    actions.clear();
+    for (int cell = 0; cell < cells; ++cell) {
+        std::uint8_t seen = world.seen[cell];
+        if (seen == MctsWorld::Unknown || seen == MctsWorld::HitDamaged || seen == MctsWorld::KnownShip) {
+            actions.push_back(cell);
+        }
+    }
+    if (!ability_phase) {
+        return;
+    }
+
+    AbilityKind kind = world.queue[world.queue_head];
+    if (kind == AbilityKind::Bombardment) {
+        actions.push_back(cells);
+    } else if (kind == AbilityKind::DoubleDamage) {
+        for (int cell = 0; cell < cells; ++cell) {
+            if (world.seen[cell] == MctsWorld::Unknown || world.seen[cell] == MctsWorld::KnownShip) {
+                actions.push_back(cells + cell);
+            }
+        }
+    } else {
+        for (int y = 0; y < world.height; ++y) {
+            for (int x = 0; x < world.width; ++x) {
+                bool useful = false;
+                for (int sy = y; sy < y + 2 && sy < world.height; ++sy) {
+                    for (int sx = x; sx < x + 2 && sx < world.width; ++sx) {
+                        useful = useful || world.seen[sy * world.width + sx] == MctsWorld::Unknown;
+                    }
+                }
+                if (useful) {
+                    actions.push_back(cells + y * world.width + x);
+                }
+            }
+        }
+    }
+}
+
+int MctsAI::prior(const MctsWorld& world, int action) {
+    int cells = world.width * world.height;
+    if (action >= cells && world.queue[world.queue_head] == AbilityKind::Bombardment) {
+        return 3;
+    }
+    if (action >= cells && world.queue[world.queue_head] == AbilityKind::Scanner) {
+        return 1;
+    }
+    int cell = action % cells;
+    std::uint8_t seen = world.seen[cell];
+    if (seen == MctsWorld::HitDamaged || seen == MctsWorld::KnownShip) {
+        return 3;
+    }
+    int x = cell % world.width;
+    int y = cell / world.width;
+    for (int i = 0; i < Neighborhood::orthogonalCount; ++i) {
+        int nx = x + Neighborhood::around[i].x;
+        int ny = y + Neighborhood::around[i].y;
+        if (nx >= 0 && nx < world.width && ny >= 0 && ny < world.height) {
+            std::uint8_t near = world.seen[ny * world.width + nx];
+            if (near == MctsWorld::HitDamaged || near == MctsWorld::HitDone) {
+                return 2;
+            }
+        }
+    }
+    return 1;
+}
+
+void MctsAI::shoot(MctsWorld& world, int cell, int damage, std::mt19937_64& rng) {
+    int ship = world.ship[cell];
+    if (ship < 0) {
+        world.seen[cell] = MctsWorld::Closed;
+        return;
+    }
+    int dealt = std::min<int>(damage, world.hp[cell]);
+    world.hp[cell] -= dealt;
+    world.ship_hp[ship] -= dealt;
+    world.seen[cell] = world.hp[cell] > 0 ? MctsWorld::HitDamaged : MctsWorld::HitDone;
+    if (dealt == 0 || world.ship_hp[ship] > 0) {
+        return;
+    }
+
+    // Корабль потоплен: его клетки и ореол закрыты, бот получает случайную способность
+    --world.alive_ships;
+    const std::vector<int>& cells = world.ship_cells[ship];
+    bool vertical = cells.size() > 1 && cells[1] - cells[0] == world.width;
+    const ShipArea& area = Neighborhood::area({cells[0] % world.width, cells[0] / world.width},
+                                              static_cast<int>(cells.size()),
+                                              vertical ? Orientation::Vertical : Orientation::Horizontal);
+    Neighborhood::forEachHaloCell(area, world.width, world.height,
+                                  [&](Coords coords) { world.seen[coords.y * world.width + coords.x] = MctsWorld::Closed; });
+    world.queue.push_back(static_cast<AbilityKind>(rng() % abilityKindCount));
+}
+
+void MctsAI::useAbility(MctsWorld& world, int cell, std::mt19937_64& rng) {
+    AbilityKind kind = world.queue[world.queue_head++];
+    world.ability_used = true;
+
+    if (kind == AbilityKind::DoubleDamage) {
+        shoot(world, cell, 2, rng);
+    } else if (kind == AbilityKind::Scanner) {
+        int x = cell % world.width;
+        int y = cell / world.width;
+        for (int sy = y; sy < y + 2 && sy < world.height; ++sy) {
+            for (int sx = x; sx < x + 2 && sx < world.width; ++sx) {
+                int scanned = sy * world.width + sx;
+                if (world.seen[scanned] == MctsWorld::Unknown) {
+                    world.seen[scanned] = world.ship[scanned] >= 0 ? MctsWorld::KnownShip : MctsWorld::Closed;
+                }
+            }
+        }
+    } else {
+        // Обстрел бьет по равновероятно выбранному живому сегменту, не раскрывая его положение
+        int live = 0;
+        int chosen = -1;
+        for (int i = 0; i < world.width * world.height; ++i) {
+            if (world.ship[i] >= 0 && world.hp[i] > 0 && rng() % ++live == 0) {
+                chosen = i;
+            }
+        }
+        if (chosen >= 0) {
+            std::uint8_t seen = world.seen[chosen];
+            shoot(world, chosen, 1, rng);
+            if (world.seen[chosen] != MctsWorld::Closed) {
+                world.seen[chosen] = seen;
+            }
+        }
+    }
+}
+
+void MctsAI::applyAction(MctsWorld& world, int action, std::mt19937_64& rng) {
+    int cells = world.width * world.height;
+    if (action < cells) {
+        shoot(world, action, 1, rng);
+        ++world.turns;
+        world.ability_used = false;
+    } else {
+        useAbility(world, action - cells, rng);
+    }
+}
+
+bool MctsAI::isOpenTarget(const MctsWorld& world, int cell) {
+    std::uint8_t seen = world.seen[cell];
+    return seen == MctsWorld::Unknown || seen == MctsWorld::HitDamaged || seen == MctsWorld::KnownShip;
+}
+
+void MctsAI::pushFocus(const MctsWorld& world, int cell, std::vector<int>& focus) {
+    if (world.seen[cell] == MctsWorld::HitDamaged || world.seen[cell] == MctsWorld::KnownShip) {
+        focus.push_back(cell);
+    }
+    if (world.seen[cell] != MctsWorld::HitDamaged && world.seen[cell] != MctsWorld::HitDone) {
+        return;
+    }
+    int x = cell % world.width;
+    int y = cell / world.width;
+    if (x > 0 && world.seen[cell - 1] == MctsWorld::Unknown) focus.push_back(cell - 1);
+    if (x + 1 < world.width && world.seen[cell + 1] == MctsWorld::Unknown) focus.push_back(cell + 1);
+    if (y > 0 && world.seen[cell - world.width] == MctsWorld::Unknown) focus.push_back(cell - world.width);
+    if (y + 1 < world.height && world.seen[cell + world.width] == MctsWorld::Unknown) focus.push_back(cell + world.width);
+}
+
+double MctsAI::rollout(MctsWorld& world, const Root& root, std::mt19937_64& rng) {
+    // Стратегия симуляции "охота и добивание": сначала известные и соседние с попаданиями клетки,
+    // затем неизвестные клетки в случайном порядке, взвешенном по карте вероятностей корня
+    // (чем вероятнее клетка, тем раньше она в очереди). Обе очереди обновляются инкрементально.
+    int cells = world.width * world.height;
+    std::vector<std::pair<double, int>> keyed;
+    std::vector<int> order;
+    std::vector<int> focus;
+    keyed.reserve(cells);
+    order.reserve(cells);
+    std::uniform_real_distribution<double> uniform(1e-12, 1.0);
+    for (int cell = 0; cell < cells; ++cell) {
+        if (world.seen[cell] == MctsWorld::Unknown) {
+            keyed.push_back({std::log(uniform(rng)) / (root.prior[cell] + 1e-3), cell});
+        }
+    }
+    std::sort(keyed.begin(), keyed.end());
+    for (const auto& entry : keyed) {
+        order.push_back(entry.second); // последний элемент - самый ранний по ключу
+    }
+    for (int cell = 0; cell < cells; ++cell) {
+        pushFocus(world, cell, focus);
+    }
+
+    auto next_target = [&]() {
+        while (!focus.empty()) {
+            int cell = focus.back();
+            focus.pop_back();
+            if (isOpenTarget(world, cell)) {
+                return cell;
+            }
+        }
+        while (!order.empty()) {
+            int cell = order.back();
+            order.pop_back();
+            if (isOpenTarget(world, cell)) {
+                return cell;
+            }
+        }
+        return -1;
+    };
+
+    int limit = 4 * cells;
+    while (world.alive_ships > 0 && world.turns < limit) {
+        if (!world.ability_used && world.queue_head < static_cast<int>(world.queue.size())) {
+            AbilityKind kind = world.queue[world.queue_head];
+            int target = next_target();
+            if (target >= 0) {
+                focus.push_back(target); // клетка остается целью для выстрела
+            }
+            useAbility(world, std::max(target, 0), rng);
+            if (world.alive_ships == 0) {
+                break;
+            }
+            if (target >= 0 && kind == AbilityKind::Scanner) {
+                for (int sy = target / world.width; sy < target / world.width + 2 && sy < world.height; ++sy) {
+                    for (int sx = target % world.width; sx < target % world.width + 2 && sx < world.width; ++sx) {
+                        pushFocus(world, sy * world.width + sx, focus);
+                    }
+                }
+            } else if (target >= 0) {
+                pushFocus(world, target, focus);
+            }
+        }
+        int target = next_target();
+        if (target < 0) {
+            break;
+        }
+        applyAction(world, target, rng);
+        pushFocus(world, target, focus);
+    }
+    // Чем меньше ходов понадобилось для потопления флота, тем лучше
+    return std::min(1.0, static_cast<double>(root.total_hp) / std::max(world.turns, 1));
+}
+
+void MctsAI::searchTree(const Root& root, bool ability_allowed, std::chrono::steady_clock::time_point deadline,
+                        std::uint64_t seed, std::vector<int>& root_visits, int& iterations) const {
+    NodePool pool(pool_capacity);
+    pool.allocate();
+    std::mt19937_64 rng(seed);
+    int action_count = root.width * root.height * 2;
+    std::vector<int> legal_stamp(action_count, 0);
+    std::vector<int> child_stamp(action_count, 0);
+    std::vector<int> child_of(action_count, -1);
+    std::vector<int> actions;
+    std::vector<int> path;
+    MctsWorld world;
+    int stamp = 0;
+    int failures = 0; // неудачные расстановки подряд
+
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (!determinize(root, world, rng)) {
+            if (++failures >= failedWorldLimit) {
+                break; // расстановка, согласная с наблюдениями, почти не находится
+            }
+            continue;
+        }
+        failures = 0;
+        world.ability_used = !ability_allowed;
+        int node = 0;
+        path.assign(1, 0);
+
+        while (world.alive_ships > 0) {
+            bool ability_phase = !world.ability_used && world.queue_head < static_cast<int>(world.queue.size());
+            legalActions(world, ability_phase, actions);
+            if (actions.empty()) {
+                break;
+            }
+            ++stamp;
+            for (int action : actions) {
+                legal_stamp[action] = stamp;
+            }
+            for (int child = pool[node].first_child; child != -1; child = pool[child].next_sibling) {
+                int action = pool[child].action;
+                if (legal_stamp[action] == stamp) {
+                    ++pool[child].availability;
+                    child_stamp[action] = stamp;
+                    child_of[action] = child;
+                }
+            }
+
+            // Прогрессивное расширение: новые действия добавляются по мере роста числа посещений узла
+            int untried = -1;
+            double untried_prior = -1.0;
+            int ties = 0;
+            bool widen = pool[node].children < 1 + wideningFactor * std::sqrt(pool[node].visits);
+            for (int action : actions) {
+                if (!widen || child_stamp[action] == stamp) {
+                    continue;
+                }
+                double value = node == 0 ? root.prior[action] : prior(world, action);
+                if (value > untried_prior) {
+                    untried_prior = value;
+                    ties = 0;
+                }
+                if (value == untried_prior && rng() % ++ties == 0) {
+                    untried = action;
+                }
+            }
+
+            if (untried != -1 && !pool.full()) {
+                int child = pool.allocate();
+                pool[child].action = untried;
+                pool[child].parent = node;
+                pool[child].availability = 1;
+                pool[child].next_sibling = pool[node].first_child;
+                pool[node].first_child = child;
+                ++pool[node].children;
+                applyAction(world, untried, rng);
+                path.push_back(child);
+                break;
+            }
+
+            // В корне отбор ведется по PUCT с априорными оценками карты вероятностей: разница наград
+            // между соседними выстрелами мала по сравнению с шумом детерминизаций, и без априорной
+            // оценки поиск выбирал бы среди лучших действий почти случайно. Глубже - обычный UCB.
+            double prior_total = 0.0;
+            if (node == 0) {
+                for (int action : actions) {
+                    prior_total += root.prior[action] + 1e-3;
+                }
+            }
+            int best = -1;
+            double best_score = -1e18;
+            for (int action : actions) {
+                if (child_stamp[action] != stamp) {
+                    continue;
+                }
+                const MctsNode& child = pool[child_of[action]];
+                double mean = child.visits == 0 ? 0.0 : child.value / child.visits;
+                double score;
+                if (node == 0) {
+                    double p = (root.prior[action] + 1e-3) / prior_total;
+                    score = mean + priorConstant * p * std::sqrt(static_cast<double>(pool[node].visits)) / (1 + child.visits);
+                } else {
+                    score = child.visits == 0 ? 1e9 :
+                        mean + explorationConstant * std::sqrt(std::log(child.availability) / child.visits);
+                }
+                if (score > best_score) {
+                    best_score = score;
+                    best = child_of[action];
+                }
+            }
+            if (best == -1) {
+                break; // раскрывать нечего (арена заполнена), дальше только случайная симуляция
+            }
+            applyAction(world, pool[best].action, rng);
+            node = best;
+            path.push_back(best);
+        }
+
+        double reward = rollout(world, root, rng);
+        for (int visited : path) {
+            ++pool[visited].visits;
+            pool[visited].value += reward;
+        }
+        ++iterations;
+    }
+
+    for (int child = pool[0].first_child; child != -1; child = pool[child].next_sibling) {
+        root_visits[pool[child].action] += pool[child].visits;
+    }
+}
+
+MctsMove MctsAI::search(const GameField& field, ShipManager& manager, const std::vector<std::int8_t>& scanned,
+                        const std::vector<AbilityKind>& queue, bool ability_allowed) const {
+    if (field.getWidth() > maximalFieldSize || field.getHeight() > maximalFieldSize) {
+        return MctsMove(); // расстановки и ореолы поиска построены на классических таблицах
+    }
+    ability_allowed = ability_allowed && !queue.empty();
+    std::uint64_t observation_key = EnemyAI::observationKey(field, manager, scanned);
+    std::uint64_t queue_key = ability_allowed ? 1 : 0;
+    for (AbilityKind kind : queue) {
+        queue_key = queue_key * Zobrist::queueBase + Zobrist::ability(static_cast<int>(kind));
+    }
+    std::uint64_t key = observation_key ^ Zobrist::rotate(Zobrist::mix(queue_key), 41);
+
+    int cells = field.getWidth() * field.getHeight();
+    MctsCacheEntry entry;
+    if (sharedCache().probe(key, entry) && entry.iterations >= reuseIterations &&
+        entry.action >= 0 && entry.action < cells * 2 && (entry.action < cells || ability_allowed)) {
+        MctsMove move;
+        move.use_ability = entry.action >= cells;
+        move.target = {(entry.action % cells) % field.getWidth(), (entry.action % cells) / field.getWidth()};
+        move.iterations = entry.iterations;
+        return move;
+    }
+
+    Root root = observe(field, manager, scanned, queue, observation_key);
+    int thread_count = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    auto deadline = std::chrono::steady_clock::now() + budget;
+
+    std::vector<std::vector<int>> visits(thread_count, std::vector<int>(cells * 2, 0));
+    std::vector<int> iterations(thread_count, 0);
+    std::uint64_t seed = std::random_device{}();
+    std::vector<std::thread> workers;
+    for (int i = 1; i < thread_count; ++i) {
+        workers.emplace_back([&, i]() {
+            searchTree(root, ability_allowed, deadline, seed + i * 0x9E3779B97F4A7C15ULL, visits[i], iterations[i]);
+        });
+    }
+    searchTree(root, ability_allowed, deadline, seed, visits[0], iterations[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    MctsMove move;
+    int best_action = -1;
+    int best_visits = 0;
+    for (int action = 0; action < cells * 2; ++action) {
+        int total = 0;
+        for (int i = 0; i < thread_count; ++i) {
+            total += visits[i][action];
+        }
+        if (total > best_visits) {
+            best_visits = total;
+            best_action = action;
+        }
+    }
+    for (int count : iterations) {
+        move.iterations += count;
+    }
+
+    if (best_action == -1) {
+        // Поиск ничего не посчитал (нет времени или расстановки, согласной с наблюдениями):
+        // стреляем в первую клетку, которая еще может дать урон
+        for (int cell = 0; cell < cells && best_action == -1; ++cell) {
+            if (EnemyAI::isTarget(field, {cell % root.width, cell / root.width})) {
+                best_action = cell;
+            }
+        }
+        best_action = std::max(best_action, 0);
+    } else if (!sharedCache().probe(key, entry) || entry.iterations < move.iterations) {
+        sharedCache().store(key, MctsCacheEntry{best_action, move.iterations}, move.iterations);
+    }
+    move.use_ability = best_action >= cells;
+    move.target = {(best_action % cells) % root.width, (best_action % cells) / root.width};
+    return move;
+}
+
+TranspositionTable<MctsCacheEntry>& MctsAI::sharedCache() {
+    static TranspositionTable<MctsCacheEntry> cache(cacheEntries);
+    return cache;
+}
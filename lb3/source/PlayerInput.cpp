@@ -0,0 +1,176 @@
+#include "PlayerInput.h"
+#include "Exceptions.h"
+#include <iostream>
+#include <iterator>
+#include <cstdlib>
+
+bool ConsoleInput::ask(InputStep step) {
+    switch (step) {
+    case InputStep::LoadGame:
+        std::cout << "Хотите загрузить игру? (y/n): ";
+        break;
+    case InputStep::SaveGame:
+        std::cout << "Хотите сохранить игру? (y/n): ";
+        break;
+    case InputStep::UseAbility:
+        std::cout << "Вы хотите использовать способность? y/n\n";
+        break;
+    case InputStep::PlayAgain:
+        std::cout << "Сыграем еще раз? (y/n): ";
+        break;
+    default:
+        break;
+    }
+    char answer = 'n';
+    std::cin >> answer;
+    return answer == 'y';
+}
+
+std::string ConsoleInput::readFileName(InputStep) {
+    std::string file_name;
+    std::cout << "Введите имя файла: ";
+    std::cin >> file_name;
+    return file_name;
+}
+
+Coords ConsoleInput::readCoords(InputStep step) {
+    int x = 0;
+    int y = 0;
+    if (step == InputStep::UseAbility) {
+        std::cout << "Введите координаты для применения способности (x y): ";
+    } else {
+        std::cout << "Введите координаты атаки (x y): ";
+    }
+    std::cin >> x >> y;
+    return {x, y};
+}
+
+ScriptInput::ScriptInput(std::istream& script, std::ostream* results) : results(results) {
+    std::string text(std::istreambuf_iterator<char>(script), {});
+    parse(text);
+}
+
+void ScriptInput::parse(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::vector<int> lines;
+    int line = 1;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (c == '#') {
+            while (i < text.size() && text[i] != '\n') {
+                ++i;
+            }
+        } else if (c == '\n') {
+            ++line;
+            ++i;
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == ';') {
+            ++i;
+        } else {
+            std::size_t start = i;
+            while (i < text.size() && text[i] != ' ' && text[i] != '\t' && text[i] != '\r' &&
+                   text[i] != '\n' && text[i] != ';' && text[i] != '#') {
+                ++i;
+            }
+            tokens.push_back(text.substr(start, i - start));
+            lines.push_back(line);
+        }
+    }
+
+    auto number = [&](std::size_t index) {
+        if (index >= tokens.size()) {
+            fail(lines.back(), "missing coordinate");
+        }
+        char* end = nullptr;
+        long value = std::strtol(tokens[index].c_str(), &end, 10);
+        if (*end != '\0' || tokens[index].empty()) {
+            fail(lines[index], "bad number " + tokens[index]);
+        }
+        return static_cast<int>(value);
+    };
+
+    for (std::size_t t = 0; t < tokens.size();) {
+        const std::string& op = tokens[t];
+        Command command {op[0], "", {0, 0}, lines[t]};
+        if (op.size() != 1) {
+            fail(lines[t], "unknown command " + op);
+        }
+        if (command.op == 'l' || command.op == 's') {
+            if (t + 1 >= tokens.size()) {
+                fail(lines[t], "missing file name");
+            }
+            command.file_name = tokens[t + 1];
+            t += 2;
+        } else if (command.op == 'u' || command.op == 'a') {
+            command.target = {number(t + 1), number(t + 2)};
+            t += 3;
+        } else if (command.op == 'r') {
+            t += 1;
+        } else {
+            fail(lines[t], "unknown command " + op);
+        }
+        commands.push_back(std::move(command));
+    }
+}
+
+char ScriptInput::opFor(InputStep step) {
+    switch (step) {
+    case InputStep::LoadGame:
+        return 'l';
+    case InputStep::SaveGame:
+        return 's';
+    case InputStep::UseAbility:
+        return 'u';
+    case InputStep::Attack:
+        return 'a';
+    default:
+        return 'r';
+    }
+}
+
+bool ScriptInput::ask(InputStep step) {
+    if (next < commands.size() && commands[next].op == opFor(step)) {
+        accepted = ++next;
+        return true;
+    }
+    accepted = 0;
+    return false;
+}
+
+std::string ScriptInput::readFileName(InputStep step) {
+    if (accepted == 0 || commands[accepted - 1].op != opFor(step)) {
+        throw std::logic_error("File name requested without a matching script command");
+    }
+    return commands[accepted - 1].file_name;
+}
+
+Coords ScriptInput::readCoords(InputStep step) {
+    if (step == InputStep::Attack) {
+        if (next >= commands.size()) {
+            throw ScriptFinishedException();
+        }
+        if (commands[next].op != 'a') {
+            fail(commands[next].line, std::string("expected an attack, got '") + commands[next].op + "'");
+        }
+        accepted = ++next;
+    }
+    if (accepted == 0 || commands[accepted - 1].op != opFor(step)) {
+        throw std::logic_error("Coordinates requested without a matching script command");
+    }
+    return commands[accepted - 1].target;
+}
+
+void ScriptInput::fail(int line, const std::string& message) {
+    report("script_error " + std::to_string(line) + " " + message);
+    throw ScriptErrorException(line, message);
+}
+
+void ScriptInput::report(const std::string& event) {
+    if (results != nullptr) {
+        *results << event << '\n';
+    }
+}
+
+bool ScriptInput::isFinished() const {
+    return next >= commands.size();
+}
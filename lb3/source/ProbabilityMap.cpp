@@ -0,0 +1,207 @@
+#include "ProbabilityMap.h"
+#include "Neighborhood.h"
+#include "BoardGeometry.h"
+#include <algorithm>
+
+constexpr double hitWeight = 20.0; // положения через известные попадания намного вероятнее
+constexpr std::size_t cacheEntries = 2048;
+
+ProbabilityMap::ProbabilityMap(int width, int height)
+    : width(width), height(height), probability(width * height, 0.0) {}
+
+// Знание о клетках в out (geometry.cells() элементов)
+template <typename Geometry>
+static void observeInto(const GameField& field, const std::vector<std::int8_t>& scanned, const Geometry& geometry,
+                        CellKnowledge* knowledge) {
+    int width = geometry.width();
+    int height = geometry.height();
+    for (int y = 0; y < height; ++y) { // размеры geometry совпадают с полем
+        for (int x = 0; x < width; ++x) {
+            const Cell& cell = *field.findCell({x, y});
+            int index = geometry.index({x, y});
+            knowledge[index] = CellKnowledge::Open;
+            if (!scanned.empty() && scanned[index] < 0) {
+                knowledge[index] = CellKnowledge::Blocked;
+            }
+            if (!scanned.empty() && scanned[index] > 0) {
+                knowledge[index] = CellKnowledge::KnownShip;
+            }
+            if (cell.status_cell == Status::Empty) {
+                knowledge[index] = CellKnowledge::Blocked;
+            } else if (cell.status_cell == Status::Ship && cell.ship_segment_pointer != nullptr) {
+                knowledge[index] = CellKnowledge::KnownShip;
+            }
+        }
+    }
+
+    // Потопленный корабль объявляется: его клетки и ореол уже не могут содержать живые корабли
+    bool fits_tables = width <= neighborhoodSide && height <= neighborhoodSide;
+    Bitboard sunk_halo;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const Cell& cell = *field.findCell({x, y});
+            const Ship::ShipSegment* segment = cell.ship_segment_pointer;
+            // Сегмент, уничтоженный обстрелом, известен, хотя статус его клетки остался Unknown
+            if (segment == nullptr || segment->ship_pointer->isAlive() ||
+                (cell.status_cell != Status::Ship && segment->status != SegmentStatus::Destroyed)) {
+                continue;
+            }
+            if (fits_tables) {
+                Neighborhood::markHalo(sunk_halo, Neighborhood::cell({x, y}), width, height);
+                continue;
+            }
+            knowledge[geometry.index({x, y})] = CellKnowledge::Blocked; // большое поле - соседи по одному
+            for (Coords offset : Neighborhood::around) {
+                Coords near {x + offset.x, y + offset.y};
+                if (geometry.contains(near)) {
+                    knowledge[geometry.index(near)] = CellKnowledge::Blocked;
+                }
+            }
+        }
+    }
+    if (fits_tables) {
+        Neighborhood::forEachCell(sunk_halo, width, height, [&](Coords coords) {
+            knowledge[geometry.index(coords)] = CellKnowledge::Blocked;
+        });
+    }
+}
+
+// Перебор положений кораблей; для классического поля все размеры - константы компиляции
+template <typename Geometry>
+static void accumulate(const GameField& field, const std::vector<int>& remaining_lengths,
+                       const std::vector<std::int8_t>& scanned, const Geometry& geometry,
+                       std::vector<double>& probability) {
+    int width = geometry.width();
+    int height = geometry.height();
+    typename Geometry::template Cells<CellKnowledge> knowledge = geometry.makeCells(CellKnowledge::Open);
+    observeInto(field, scanned, geometry, knowledge.data());
+
+    int counts[maximalShipLength + 1] = {};
+    for (int length : remaining_lengths) {
+        if (length >= minimalShipLength && length <= maximalShipLength) {
+            ++counts[length];
+        }
+    }
+
+    typename Geometry::template Cells<double> cover = geometry.makeCells(0.0);
+    for (int length = minimalShipLength; length <= maximalShipLength; ++length) {
+        if (counts[length] == 0) {
+            continue;
+        }
+        std::fill(cover.begin(), cover.end(), 0.0);
+        double total = 0.0;
+
+        for (int vertical = 0; vertical < 2; ++vertical) {
+            if (length == 1 && vertical == 1) {
+                break; // однопалубный корабль не зависит от ориентации
+            }
+            int step = vertical ? width : 1;
+            int max_x = width - (vertical ? 0 : length - 1);
+            int max_y = height - (vertical ? length - 1 : 0);
+            for (int y = 0; y < max_y; ++y) {
+                for (int x = 0; x < max_x; ++x) {
+                    int start = geometry.index({x, y});
+                    double weight = 1.0;
+                    bool possible = true;
+                    for (int i = 0; i < length; ++i) {
+                        CellKnowledge k = knowledge[start + step * i];
+                        if (k == CellKnowledge::Blocked) {
+                            possible = false;
+                            break;
+                        }
+                        if (k == CellKnowledge::KnownShip) {
+                            weight *= hitWeight;
+                        }
+                    }
+                    if (!possible) {
+                        continue;
+                    }
+                    total += weight;
+                    for (int i = 0; i < length; ++i) {
+                        cover[start + step * i] += weight;
+                    }
+                }
+            }
+        }
+
+        if (total <= 0.0) {
+            continue;
+        }
+        for (int i = 0; i < geometry.cells(); ++i) {
+            probability[i] += counts[length] * cover[i] / total;
+        }
+    }
+
+    for (int i = 0; i < geometry.cells(); ++i) {
+        if (knowledge[i] == CellKnowledge::Blocked) {
+            probability[i] = 0.0;
+        }
+        probability[i] = static_cast<float>(std::min(probability[i], 1.0));
+    }
+}
+
+std::vector<CellKnowledge> ProbabilityMap::observe(const GameField& field, const std::vector<std::int8_t>& scanned) {
+    std::vector<CellKnowledge> knowledge(field.getWidth() * field.getHeight());
+    observeInto(field, scanned, DynamicGeometry(field.getWidth(), field.getHeight()), knowledge.data());
+    return knowledge;
+}
+
+ProbabilityMap ProbabilityMap::build(const GameField& field, const std::vector<int>& remaining_lengths,
+                                     const std::vector<std::int8_t>& scanned) {
+    ProbabilityMap map(field.getWidth(), field.getHeight());
+    withGeometry(field.getWidth(), field.getHeight(), [&](const auto& geometry) {
+        accumulate(field, remaining_lengths, scanned, geometry, map.probability);
+    });
+    return map;
+}
+
+ProbabilityMap ProbabilityMap::cached(std::uint64_t key, const GameField& field, const std::vector<int>& remaining_lengths,
+                                      const std::vector<std::int8_t>& scanned) {
+    if (field.getWidth() > maximalFieldSize || field.getHeight() > maximalFieldSize) {
+        return build(field, remaining_lengths, scanned); // запись кэша рассчитана на классическое поле
+    }
+    TranspositionTable<ProbabilityMapEntry>& cache = sharedCache();
+    ProbabilityMapEntry entry;
+    if (cache.probe(key, entry) && entry.width == field.getWidth() && entry.height == field.getHeight()) {
+        ProbabilityMap map(entry.width, entry.height);
+        for (int i = 0; i < entry.width * entry.height; ++i) {
+            map.probability[i] = entry.probability[i];
+        }
+        return map;
+    }
+
+    ProbabilityMap map = build(field, remaining_lengths, scanned);
+    entry.width = static_cast<std::uint8_t>(map.width);
+    entry.height = static_cast<std::uint8_t>(map.height);
+    for (int i = 0; i < map.width * map.height; ++i) {
+        entry.probability[i] = static_cast<float>(map.probability[i]);
+    }
+    // Ранние состояния (много непотопленных кораблей) повторяются чаще, в том числе между партиями,
+    // поэтому при вытеснении они ценнее поздних
+    int remaining = 0;
+    for (int length : remaining_lengths) {
+        remaining += length;
+    }
+    cache.store(key, entry, remaining);
+    return map;
+}
+
+TranspositionTable<ProbabilityMapEntry>& ProbabilityMap::sharedCache() {
+    static TranspositionTable<ProbabilityMapEntry> cache(cacheEntries);
+    return cache;
+}
+
+double ProbabilityMap::at(Coords coords) const {
+    if (coords.x < 0 || coords.x >= width || coords.y < 0 || coords.y >= height) {
+        return 0.0;
+    }
+    return probability[coords.y * width + coords.x];
+}
+
+int ProbabilityMap::getWidth() const {
+    return width;
+}
+
+int ProbabilityMap::getHeight() const {
+    return height;
+}
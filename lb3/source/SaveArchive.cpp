@@ -0,0 +1,161 @@
+#include "SaveArchive.h"
+#include "BinarySave.h"
+#include "ByteStream.h"
+#include "FileExeption.h"
+#include "Game.h"
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const std::uint8_t magic[4] = {'B', 'A', 'R', 'C'};
+static const std::uint8_t index_magic[4] = {'B', 'I', 'D', 'X'};
+static const std::uint16_t archive_version = 1;
+static const std::size_t header_size = 8;
+static const std::size_t footer_size = 16;
+static const std::size_t index_entry_size = 12;
+
+SaveArchiveWriter::SaveArchiveWriter(const std::string& file_name) : file_handler(file_name) {
+    file_handler.openForWrite();
+    std::vector<std::uint8_t> header(magic, magic + sizeof(magic));
+    ByteWriter writer(header);
+    writer.u16(archive_version);
+    writer.u16(0);
+    file_handler.writeBytes(header);
+    offset = header.size();
+}
+
+SaveArchiveWriter::~SaveArchiveWriter() {
+    try {
+        finish();
+    } catch (const FileExeption& e) {
+        std::cerr << "Error while closing save archive: " << e.what() << std::endl;
+    }
+}
+
+std::size_t SaveArchiveWriter::add(const SaveImage& image) {
+    if (finished) {
+        throw std::runtime_error("Save archive is already finished");
+    }
+    std::vector<std::uint8_t> data = BinarySave::encode(image);
+    file_handler.writeBytes(data);
+    ByteWriter writer(index);
+    writer.u64(offset);
+    writer.u32(static_cast<std::uint32_t>(data.size()));
+    offset += data.size();
+    return count++;
+}
+
+std::size_t SaveArchiveWriter::add(Game& game) {
+    return add(SaveImage::capture(game));
+}
+
+void SaveArchiveWriter::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    ByteWriter writer(index);
+    writer.u64(offset);
+    writer.u32(static_cast<std::uint32_t>(count));
+    index.insert(index.end(), index_magic, index_magic + sizeof(index_magic));
+    file_handler.writeBytes(index);
+    file_handler.closeWrite();
+}
+
+SaveArchive::SaveArchive(const std::string& file_name) {
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FileExeption("Can't open archive for reading");
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(header_size + footer_size)) {
+        ::close(fd);
+        throw std::runtime_error("Not a save archive");
+    }
+    mapping_size = info.st_size;
+    void* address = ::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // отображение остается действительным после закрытия файла
+    if (address == MAP_FAILED) {
+        throw FileExeption("Can't map archive");
+    }
+    mapping = static_cast<const std::uint8_t*>(address);
+
+    try {
+        ByteReader header(mapping, 0, header_size);
+        if (!std::equal(magic, magic + sizeof(magic), mapping)) {
+            throw std::runtime_error("Not a save archive");
+        }
+        header.u32();
+        int file_version = header.u16();
+        if (file_version != archive_version) {
+            throw std::runtime_error("Unsupported archive version " + std::to_string(file_version));
+        }
+
+        std::size_t footer = mapping_size - footer_size;
+        ByteReader tail(mapping, footer, mapping_size);
+        std::uint64_t index_offset = tail.u64();
+        count = tail.u32();
+        if (!std::equal(index_magic, index_magic + sizeof(index_magic), mapping + footer + 12)) {
+            throw std::runtime_error("Archive index is missing");
+        }
+        if (index_offset < header_size || index_offset > footer ||
+            (footer - index_offset) / index_entry_size != count || (footer - index_offset) % index_entry_size != 0) {
+            throw std::runtime_error("Archive index is corrupted");
+        }
+        index = mapping + index_offset;
+    } catch (...) {
+        ::munmap(const_cast<std::uint8_t*>(mapping), mapping_size);
+        throw;
+    }
+    ::madvise(const_cast<std::uint8_t*>(mapping), mapping_size, MADV_RANDOM);
+}
+
+SaveArchive::~SaveArchive() {
+    ::munmap(const_cast<std::uint8_t*>(mapping), mapping_size);
+}
+
+std::size_t SaveArchive::size() const {
+    return count;
+}
+
+SaveArchive::Record SaveArchive::record(std::size_t number) const {
+    if (number >= count) {
+        throw std::out_of_range("Archive record number is out of range");
+    }
+    ByteReader entry(index, number * index_entry_size, (number + 1) * index_entry_size);
+    std::uint64_t start = entry.u64();
+    std::size_t length = entry.u32();
+    std::size_t index_offset = index - mapping;
+    if (start < header_size || start > index_offset || length > index_offset - start) {
+        throw std::runtime_error("Archive record is out of bounds");
+    }
+    return Record{mapping + start, length};
+}
+
+SaveImage SaveArchive::image(std::size_t number) const {
+    Record data = record(number);
+    return BinarySave::decode(data.data, data.size);
+}
+
+Game SaveArchive::load(std::size_t number) const {
+    return image(number).restore();
+}
+
+void SaveArchive::scan(const std::function<bool(std::size_t number, const SaveImage& image)>& visit) const {
+    void* address = const_cast<std::uint8_t*>(mapping);
+    ::madvise(address, mapping_size, MADV_SEQUENTIAL);
+    try {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!visit(i, image(i))) {
+                break;
+            }
+        }
+    } catch (...) {
+        ::madvise(address, mapping_size, MADV_RANDOM);
+        throw;
+    }
+    ::madvise(address, mapping_size, MADV_RANDOM);
+}
@@ -0,0 +1,138 @@
+#include "SaveImage.h"
+#include "Game.h"
+#include <stdexcept>
+
+SaveImage SaveImage::capture(Game& game) {
+    SaveImage image;
+    image.round_counter = game.getRoundCounter();
+    image.is_player_step = game.getIsPlayerStep();
+    image.is_player_use_ability = game.getIsPlayerUseAbility();
+    image.is_player_do_attack = game.getIsPlayerDoAttack();
+    image.player = captureSide(game.getPlayerField(), game.getPlayerShipManager(), game.getPlayerAbilitiesManager());
+    image.bot = captureSide(game.getEnemyField(), game.getEnemyShipManager(), game.getEnemyAbilitiesManager());
+    return image;
+}
+
+SaveImage::SideImage SaveImage::captureSide(const GameField& field, const ShipManager& manager,
+                                            const AbilityManager& abilities) {
+    SideImage side;
+    side.width = field.getWidth();
+    side.height = field.getHeight();
+    side.cells.reserve(side.width * side.height);
+    for (int y = 0; y < side.height; ++y) {
+        for (int x = 0; x < side.width; ++x) {
+            side.cells.push_back(field.getCellStatus({x, y}));
+        }
+    }
+
+    side.ships.resize(manager.getShipCount());
+    for (int i = 0; i < manager.getShipCount(); ++i) {
+        const Ship& ship = manager.getActiveShip(i);
+        ShipImage& image = side.ships[i];
+        image.coords = ship.getCoords();
+        image.orientation = ship.getOrientation();
+        for (int j = 0; j < ship.getLength(); ++j) {
+            image.segments.push_back(ship.getSegmentByIndex(j)->getStatus());
+        }
+    }
+
+    side.abilities = abilities.getQueueKinds();
+    return side;
+}
+
+void SaveImage::validate() const {
+    validateSide(player);
+    validateSide(bot);
+}
+
+void SaveImage::validateSide(const SideImage& side) {
+    if (side.width < minimalFieldSize || side.width > maximalFieldSize ||
+        side.height < minimalFieldSize || side.height > maximalFieldSize) {
+        throw std::runtime_error("Invalid field size");
+    }
+    if (static_cast<int>(side.cells.size()) != side.width * side.height) {
+        throw std::runtime_error("Invalid field data size");
+    }
+
+    std::vector<std::uint8_t> occupied(side.cells.size(), 0);
+    for (const ShipImage& ship : side.ships) {
+        int length = ship.segments.size();
+        if (length < minimalShipLength || length > maximalShipLength ||
+            (ship.orientation != Orientation::Horizontal && ship.orientation != Orientation::Vertical)) {
+            throw std::runtime_error("Invalid ship data format");
+        }
+        int dx = ship.orientation == Orientation::Horizontal ? 1 : 0;
+        int dy = 1 - dx;
+        if (ship.coords.x < 0 || ship.coords.y < 0 ||
+            ship.coords.x + dx * (length - 1) >= side.width || ship.coords.y + dy * (length - 1) >= side.height) {
+            throw std::runtime_error("Ship is out of field");
+        }
+        for (int j = 0; j < length; ++j) {
+            int index = (ship.coords.y + dy * j) * side.width + ship.coords.x + dx * j;
+            if (occupied[index]) {
+                throw std::runtime_error("Ships overlap");
+            }
+            occupied[index] = 1;
+        }
+    }
+    // Поврежденный сегмент может быть не открыт (обстрел), но открытая клетка с кораблем без корабля - ошибка
+    for (std::size_t i = 0; i < side.cells.size(); ++i) {
+        if (side.cells[i] == Status::Ship && !occupied[i]) {
+            throw std::runtime_error("Revealed ship cell has no ship");
+        }
+    }
+}
+
+Game SaveImage::restore() const {
+    validate();
+    GameField player_field = restoreField(player);
+    ShipManager player_ships = restoreShips(player, player_field);
+    GameField bot_field = restoreField(bot);
+    ShipManager bot_ships = restoreShips(bot, bot_field);
+    return Game(std::move(player_field), std::move(bot_field), std::move(player_ships), std::move(bot_ships),
+                restoreAbilities(player), restoreAbilities(bot), round_counter, is_player_step,
+                is_player_use_ability, is_player_do_attack);
+}
+
+GameField SaveImage::restoreField(const SideImage& side) {
+    GameField field(side.width, side.height);
+    for (int y = 0; y < side.height; ++y) {
+        for (int x = 0; x < side.width; ++x) {
+            Status status = side.cells[y * side.width + x];
+            field.setCellStatus({x, y}, status);
+            if (status == Status::Empty) {
+                field.getCellAt({x, y}).missed = true;
+            }
+        }
+    }
+    return field;
+}
+
+ShipManager SaveImage::restoreShips(const SideImage& side, GameField& field) {
+    vector<int> ship_sizes;
+    for (const ShipImage& ship : side.ships) {
+        ship_sizes.push_back(ship.segments.size());
+    }
+    ShipManager ship_manager(ship_sizes);
+
+    // Статусы сегментов и здоровье записываются напрямую, до подключения к индексу живых сегментов;
+    // клетки уже получили статусы из плоскости поля
+    for (const ShipImage& image : side.ships) {
+        Ship& ship = ship_manager.getFreeShip(0);
+        field.placeRestoredShip(ship, image.coords, image.orientation);
+        ship.restoreSegments(image.segments);
+        ship_manager.moveShipToActive(0);
+    }
+    return ship_manager;
+}
+
+AbilityManager SaveImage::restoreAbilities(const SideImage& side) {
+    deque<unique_ptr<Ability>> abilities;
+    for (AbilityKind kind : side.abilities) {
+        if (static_cast<int>(kind) < 0 || static_cast<int>(kind) >= abilityKindCount) {
+            throw runtime_error("Unknown ability code");
+        }
+        abilities.push_back(AbilityManager::createAbility(kind));
+    }
+    return AbilityManager(std::move(abilities));
+}
@@ -0,0 +1,273 @@
+#include "SaveJournal.h"
+#include "BinarySave.h"
+#include "ByteStream.h"
+#include "FileHandler.h"
+#include "FileExeption.h"
+#include "Game.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <iostream>
+
+static const std::uint8_t magic[4] = {'B', 'J', 'N', 'L'};
+
+enum class RecordType { Shot = 1, Ability = 2, Grant = 3, Turn = 4 };
+// Исход способности: Hit - обстрел попал в записанную клетку, Failed - способность снята с очереди без действия
+enum class AbilityOutcome { Done = 0, Hit = 1, Failed = 2 };
+
+namespace {
+
+struct Record {
+    RecordType type = RecordType::Shot;
+    bool by_player = true;
+    AbilityKind kind = AbilityKind::DoubleDamage;
+    Coords target {0, 0};
+    bool hit = false;
+    bool failed = false;
+    Coords hit_coords {0, 0};
+};
+
+void applyRecord(Game& game, const Record& record) {
+    GameField& field = record.by_player ? game.getEnemyField() : game.getPlayerField();
+    ShipManager& ships = record.by_player ? game.getEnemyShipManager() : game.getPlayerShipManager();
+    AbilityManager& abilities = record.by_player ? game.getPlayerAbilitiesManager() : game.getEnemyAbilitiesManager();
+
+    if (record.type == RecordType::Shot) {
+        field.tryAttack(record.target);
+    } else if (record.type == RecordType::Ability) {
+        if (abilities.getQueue().empty() || abilities.getQueue().front()->getKind() != record.kind) {
+            throw std::runtime_error("Journal does not match the snapshot");
+        }
+        if (record.failed) {
+            abilities.takeAbility();
+            return;
+        }
+        if (record.hit) {
+            dynamic_cast<Bombardment&>(*abilities.getQueue().front()).presetTarget(record.hit_coords);
+        }
+        try {
+            abilities.applyAbility(field, ships, record.target);
+        } catch (const OutOfFieldAttackException&) {
+            // журнал версии 1: отказ не записан явно, при игре способность тоже была снята с очереди
+        }
+    } else if (record.type == RecordType::Grant) {
+        abilities.addAbility(AbilityManager::createAbility(record.kind));
+    }
+}
+
+}
+
+bool SaveJournal::isActive() const {
+    return !file_name.empty();
+}
+
+void SaveJournal::invalidate() {
+    file_name.clear();
+    pending.clear();
+    batches = 0;
+}
+
+int SaveJournal::getBatchCount() const {
+    return batches;
+}
+
+void SaveJournal::recordShot(bool by_player, Coords target) {
+    if (!isActive()) {
+        return;
+    }
+    ByteWriter writer(pending);
+    writer.u8(static_cast<int>(RecordType::Shot));
+    writer.u8(by_player ? 1 : 0);
+    writer.u16(target.x);
+    writer.u16(target.y);
+}
+
+void SaveJournal::recordAbility(bool by_player, const Ability& ability, Coords target) {
+    if (!isActive()) {
+        return;
+    }
+    Coords hit_coords {0, 0};
+    const Bombardment* bombardment = dynamic_cast<const Bombardment*>(&ability);
+    bool hit = bombardment != nullptr && bombardment->getHit(hit_coords);
+    // Запись собирается целиком до добавления в pending: исключение не оставит в пакете половину записи
+    std::vector<std::uint8_t> record;
+    ByteWriter writer(record);
+    writer.u8(static_cast<int>(RecordType::Ability));
+    writer.u8(by_player ? 1 : 0);
+    writer.u8(static_cast<int>(ability.getKind()));
+    writer.u32(static_cast<std::uint32_t>(target.x));
+    writer.u32(static_cast<std::uint32_t>(target.y));
+    writer.u8(static_cast<int>(hit ? AbilityOutcome::Hit : AbilityOutcome::Done));
+    if (hit) {
+        writer.u16(hit_coords.x);
+        writer.u16(hit_coords.y);
+    }
+    pending.insert(pending.end(), record.begin(), record.end());
+}
+
+void SaveJournal::recordFailedAbility(bool by_player, AbilityKind kind, Coords target) noexcept {
+    if (!isActive()) {
+        return;
+    }
+    try {
+        ByteWriter writer(pending);
+        writer.u8(static_cast<int>(RecordType::Ability));
+        writer.u8(by_player ? 1 : 0);
+        writer.u8(static_cast<int>(kind));
+        writer.u32(static_cast<std::uint32_t>(target.x));
+        writer.u32(static_cast<std::uint32_t>(target.y));
+        writer.u8(static_cast<int>(AbilityOutcome::Failed));
+    } catch (const std::exception&) {
+        invalidate(); // не хватило памяти: следующее сохранение начнет журнал со снимка
+    }
+}
+
+void SaveJournal::recordGrant(bool by_player, AbilityKind kind) {
+    if (!isActive()) {
+        return;
+    }
+    ByteWriter writer(pending);
+    writer.u8(static_cast<int>(RecordType::Grant));
+    writer.u8(by_player ? 1 : 0);
+    writer.u8(static_cast<int>(kind));
+}
+
+std::vector<std::uint8_t> SaveJournal::snapshot(const SaveImage& image) {
+    std::vector<std::uint8_t> encoded = BinarySave::encode(image);
+    std::vector<std::uint8_t> data(magic, magic + sizeof(magic));
+    ByteWriter writer(data);
+    writer.u16(version);
+    writer.u32(static_cast<std::uint32_t>(encoded.size()));
+    data.insert(data.end(), encoded.begin(), encoded.end());
+    return data;
+}
+
+bool SaveJournal::writeSnapshot(Game& game, const std::string& name) {
+    try {
+        FileHandler file_handler(name);
+        file_handler.openForWrite();
+        file_handler.writeBytes(snapshot(SaveImage::capture(game)));
+        file_handler.closeWrite();
+    } catch (const FileExeption& e) {
+        std::cerr << "Error while saving game journal: " << e.what() << std::endl;
+        invalidate();
+        return false;
+    }
+    file_name = name;
+    pending.clear();
+    batches = 0;
+    return true;
+}
+
+bool SaveJournal::save(Game& game, const std::string& name) {
+    if (name != file_name || batches >= compactEvery) {
+        return writeSnapshot(game, name);
+    }
+
+    std::vector<std::uint8_t> batch;
+    batch.swap(pending);
+    ByteWriter writer(batch);
+    writer.u8(static_cast<int>(RecordType::Turn));
+    writer.u32(static_cast<std::uint32_t>(game.getRoundCounter()));
+    writer.u8((game.getIsPlayerStep() ? 1 : 0) | (game.getIsPlayerUseAbility() ? 2 : 0) | (game.getIsPlayerDoAttack() ? 4 : 0));
+    writer.u32(BinarySave::checksum(batch.data(), batch.size()));
+    try {
+        FileHandler file_handler(name);
+        file_handler.openForAppend();
+        file_handler.writeBytes(batch);
+        file_handler.closeWrite();
+    } catch (const FileExeption& e) {
+        std::cerr << "Error while saving game journal: " << e.what() << std::endl;
+        invalidate(); // записи потеряны, следующее сохранение начнет журнал заново
+        return false;
+    }
+    ++batches;
+    return true;
+}
+
+bool SaveJournal::isJournal(const std::vector<std::uint8_t>& data) {
+    return data.size() >= sizeof(magic) && std::equal(magic, magic + sizeof(magic), data.begin());
+}
+
+Game SaveJournal::replay(const std::vector<std::uint8_t>& data) {
+    if (!isJournal(data)) {
+        throw std::runtime_error("Not a game journal");
+    }
+    ByteReader header(data, sizeof(magic), data.size());
+    int file_version = header.u16();
+    if (file_version != 1 && file_version != version) {
+        throw std::runtime_error("Unsupported journal version " + std::to_string(file_version));
+    }
+    std::size_t length = header.u32();
+    std::size_t start = header.getPosition();
+    if (length > data.size() - start) {
+        throw std::runtime_error("Journal snapshot is truncated");
+    }
+    std::vector<std::uint8_t> encoded(data.begin() + start, data.begin() + start + length);
+    Game game = BinarySave::decode(encoded).restore();
+
+    std::vector<Record> batch;
+    std::size_t position = start + length;
+    while (position < data.size()) {
+        ByteReader reader(data, position, data.size());
+        batch.clear();
+        int round = 0;
+        int flags = 0;
+        try {
+            while (true) {
+                Record record;
+                record.type = static_cast<RecordType>(reader.u8());
+                if (record.type == RecordType::Turn) {
+                    round = static_cast<int>(reader.u32());
+                    flags = reader.u8();
+                    break;
+                }
+                record.by_player = reader.u8() != 0;
+                if (record.type == RecordType::Shot) {
+                    record.target.x = reader.u16();
+                    record.target.y = reader.u16();
+                } else if (record.type == RecordType::Ability || record.type == RecordType::Grant) {
+                    int kind = reader.u8();
+                    if (kind >= abilityKindCount) {
+                        throw std::runtime_error("Unknown ability code in journal");
+                    }
+                    record.kind = static_cast<AbilityKind>(kind);
+                    if (record.type == RecordType::Ability) {
+                        if (file_version == 1) {
+                            record.target.x = reader.u16();
+                            record.target.y = reader.u16();
+                        } else {
+                            record.target.x = static_cast<std::int32_t>(reader.u32());
+                            record.target.y = static_cast<std::int32_t>(reader.u32());
+                        }
+                        int outcome = reader.u8();
+                        if (outcome > static_cast<int>(AbilityOutcome::Failed)) {
+                            throw std::runtime_error("Unknown ability outcome in journal");
+                        }
+                        record.hit = outcome == static_cast<int>(AbilityOutcome::Hit);
+                        record.failed = outcome == static_cast<int>(AbilityOutcome::Failed);
+                        if (record.hit) {
+                            record.hit_coords.x = reader.u16();
+                            record.hit_coords.y = reader.u16();
+                        }
+                    }
+                } else {
+                    throw std::runtime_error("Unknown journal record");
+                }
+                batch.push_back(record);
+            }
+            std::size_t checked = reader.getPosition() - position;
+            if (reader.u32() != BinarySave::checksum(data.data() + position, checked)) {
+                break;
+            }
+        } catch (const std::runtime_error&) {
+            break; // оборванный или поврежденный пакет: состояние на конец предыдущего пакета
+        }
+
+        for (const Record& record : batch) {
+            applyRecord(game, record);
+        }
+        game.restoreTurnState(round, (flags & 1) != 0, (flags & 2) != 0, (flags & 4) != 0);
+        position = reader.getPosition();
+    }
+    return game;
+}
@@ -0,0 +1,312 @@
+#include "SaveSaxLoader.h"
+#include "FieldCodec.h"
+#include <stdexcept>
+
+// Ключи, без которых сохранение не загрузить
+static const char* const requiredKeys[] = {
+    "round_counter", "is_player_step", "is_player_use_ability", "is_player_do_attack",
+    "player_field_width", "player_field_height", "player_field",
+    "bot_field_width", "bot_field_height", "bot_field",
+};
+constexpr int requiredKeyCount = sizeof(requiredKeys) / sizeof(requiredKeys[0]);
+constexpr unsigned playerFieldKey = 1u << 6;
+constexpr unsigned botFieldKey = 1u << 9;
+constexpr unsigned headerKeys = ((1u << requiredKeyCount) - 1) & ~playerFieldKey & ~botFieldKey;
+
+SaveImage SaveSaxLoader::parse(const std::vector<std::uint8_t>& data, unsigned sections) {
+    return parseInput(data, sections);
+}
+
+SaveImage SaveSaxLoader::parse(const std::string& text, unsigned sections) {
+    return parseInput(text, sections);
+}
+
+template <typename Input>
+SaveImage SaveSaxLoader::parseInput(const Input& input, unsigned sections) {
+    SaveSaxLoader loader;
+    loader.sections = sections;
+    loader.required = headerKeys | ((sections & PlayerSide) != 0 ? playerFieldKey : 0) |
+                      ((sections & BotSide) != 0 ? botFieldKey : 0);
+    bool parsed = nlohmann::json::sax_parse(input.begin(), input.end(), &loader);
+    if (loader.stopped) {
+        loader.finish();
+    } else if (!parsed || !loader.frames.empty()) {
+        throw std::runtime_error("Invalid JSON save");
+    }
+    if ((loader.seen & loader.required) != loader.required) {
+        throw std::runtime_error("JSON save is not an object");
+    }
+    return std::move(loader.image);
+}
+
+bool SaveSaxLoader::wanted(const std::string& name) const {
+    if (name.compare(0, 7, "player_") == 0) {
+        return (sections & PlayerSide) != 0 || name == "player_field_width" || name == "player_field_height";
+    }
+    if (name.compare(0, 4, "bot_") == 0) {
+        return (sections & BotSide) != 0 || name == "bot_field_width" || name == "bot_field_height";
+    }
+    return true;
+}
+
+SaveImage::SideImage* SaveSaxLoader::sideFor(const std::string& name) {
+    if (name.compare(0, 7, "player_") == 0) {
+        return &image.player;
+    }
+    if (name.compare(0, 4, "bot_") == 0) {
+        return &image.bot;
+    }
+    return nullptr;
+}
+
+SaveSaxLoader::FieldRows* SaveSaxLoader::rowsFor(const std::string& name) {
+    return name == "player_field" ? &player_rows : (name == "bot_field" ? &bot_rows : nullptr);
+}
+
+void SaveSaxLoader::markSeen(const std::string& name) {
+    for (int i = 0; i < requiredKeyCount; ++i) {
+        if (name == requiredKeys[i]) {
+            seen |= 1u << i;
+        }
+    }
+}
+
+bool SaveSaxLoader::integer(std::int64_t value) {
+    if (frames.empty()) {
+        throw std::runtime_error("JSON save is not an object");
+    }
+    switch (frames.back()) {
+    case Frame::Root: {
+        SaveImage::SideImage* side = sideFor(root_key);
+        if (root_key == "round_counter") {
+            image.round_counter = static_cast<int>(value);
+        } else if (side != nullptr && root_key.size() > 12 && root_key.compare(root_key.size() - 12, 12, "_field_width") == 0) {
+            side->width = static_cast<int>(value);
+        } else if (side != nullptr && root_key.size() > 13 && root_key.compare(root_key.size() - 13, 13, "_field_height") == 0) {
+            side->height = static_cast<int>(value);
+        } else {
+            return true;
+        }
+        markSeen(root_key);
+        return true;
+    }
+    case Frame::Row: {
+        if (value < static_cast<int>(Status::Unknown) || value > static_cast<int>(Status::Ship)) {
+            throw std::runtime_error("Invalid cell status in JSON save");
+        }
+        FieldRows* rows = rowsFor(root_key);
+        rows->cells.push_back(static_cast<Status>(value));
+        ++rows->current;
+        return true;
+    }
+    case Frame::ShipCoords: {
+        SaveImage::ShipImage& ship = sideFor(root_key)->ships.back();
+        if (coord_index == 0) {
+            ship.coords.x = static_cast<int>(value);
+        } else if (coord_index == 1) {
+            ship.coords.y = static_cast<int>(value);
+        }
+        ++coord_index;
+        return true;
+    }
+    case Frame::Ship:
+        if (current_key == "orientation") {
+            sideFor(root_key)->ships.back().orientation = static_cast<Orientation>(value);
+        }
+        return true;
+    case Frame::Segment:
+        if (current_key == "status") {
+            if (value < static_cast<int>(SegmentStatus::Intact) || value > static_cast<int>(SegmentStatus::Destroyed)) {
+                throw std::runtime_error("Invalid segment status in JSON save");
+            }
+            sideFor(root_key)->ships.back().segments.push_back(static_cast<SegmentStatus>(value));
+        }
+        return true;
+    case Frame::Skip:
+        return true;
+    default:
+        throw std::runtime_error("Unexpected number in JSON save");
+    }
+}
+
+bool SaveSaxLoader::null() {
+    return true; // пустой список кораблей сохраняется как null
+}
+
+bool SaveSaxLoader::boolean(bool val) {
+    if (frames.size() == 1) {
+        if (root_key == "is_player_step") {
+            image.is_player_step = val;
+        } else if (root_key == "is_player_use_ability") {
+            image.is_player_use_ability = val;
+        } else if (root_key == "is_player_do_attack") {
+            image.is_player_do_attack = val;
+        }
+        markSeen(root_key);
+    }
+    return true;
+}
+
+bool SaveSaxLoader::number_integer(number_integer_t val) {
+    return integer(val);
+}
+
+bool SaveSaxLoader::number_unsigned(number_unsigned_t val) {
+    return integer(static_cast<std::int64_t>(val));
+}
+
+bool SaveSaxLoader::number_float(number_float_t, const string_t&) {
+    if (!frames.empty() && frames.back() == Frame::Skip) {
+        return true;
+    }
+    throw std::runtime_error("Unexpected fractional number in JSON save");
+}
+
+bool SaveSaxLoader::string(string_t& val) {
+    if (frames.size() == 1 && rowsFor(root_key) != nullptr && wanted(root_key)) {
+        // упакованное поле; размеры могут идти позже, поэтому распаковка в finish()
+        rowsFor(root_key)->packed = std::move(val);
+        markSeen(root_key);
+        return true;
+    }
+    if (frames.empty() || frames.back() != Frame::Abilities) {
+        return true;
+    }
+    SaveImage::SideImage* side = sideFor(root_key);
+    if (val == "DoubleDamage") {
+        side->abilities.push_back(AbilityKind::DoubleDamage);
+    } else if (val == "Scanner") {
+        side->abilities.push_back(AbilityKind::Scanner);
+    } else if (val == "Bombardment") {
+        side->abilities.push_back(AbilityKind::Bombardment);
+    } else {
+        throw std::runtime_error("Unknown ability name in JSON");
+    }
+    return true;
+}
+
+bool SaveSaxLoader::binary(binary_t&) {
+    return true;
+}
+
+bool SaveSaxLoader::start_object(std::size_t) {
+    if (frames.empty()) {
+        frames.push_back(Frame::Root);
+    } else if (frames.back() == Frame::Ships) {
+        sideFor(root_key)->ships.emplace_back();
+        frames.push_back(Frame::Ship);
+    } else if (frames.back() == Frame::Segments) {
+        frames.push_back(Frame::Segment);
+    } else {
+        frames.push_back(Frame::Skip);
+    }
+    return true;
+}
+
+bool SaveSaxLoader::key(string_t& val) {
+    current_key = val;
+    if (frames.size() == 1) {
+        root_key = val;
+        if (sections == Header && (seen & required) == required) {
+            stopped = true; // остаток файла не нужен
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SaveSaxLoader::end_object() {
+    Frame frame = frames.back();
+    frames.pop_back();
+    if (frame == Frame::Root) {
+        finish();
+    }
+    return true;
+}
+
+bool SaveSaxLoader::start_array(std::size_t) {
+    if (frames.empty()) {
+        throw std::runtime_error("JSON save is not an object");
+    }
+    Frame top = frames.back();
+    Frame next = Frame::Skip;
+    if (top == Frame::Root && !wanted(root_key)) {
+        next = Frame::Skip;
+    } else if (top == Frame::Root) {
+        if (rowsFor(root_key) != nullptr) {
+            next = Frame::Field;
+            markSeen(root_key);
+        } else if (root_key == "player_ship_data" || root_key == "bot_ship_data") {
+            next = Frame::Ships;
+        } else if (root_key == "player_ability_manager" || root_key == "bot_ability_manager") {
+            next = Frame::Abilities;
+        }
+    } else if (top == Frame::Field) {
+        next = Frame::Row;
+        rowsFor(root_key)->current = 0;
+    } else if (top == Frame::Ship && current_key == "coords") {
+        next = Frame::ShipCoords;
+        coord_index = 0;
+    } else if (top == Frame::Ship && current_key == "segments") {
+        next = Frame::Segments;
+    }
+    frames.push_back(next);
+    return true;
+}
+
+bool SaveSaxLoader::end_array() {
+    if (frames.back() == Frame::Row) {
+        FieldRows* rows = rowsFor(root_key);
+        if (rows->columns < 0) {
+            rows->columns = rows->current;
+        } else if (rows->current != rows->columns) {
+            throw std::runtime_error("Field rows have different lengths in JSON save");
+        }
+        ++rows->rows;
+    }
+    frames.pop_back();
+    return true;
+}
+
+bool SaveSaxLoader::parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) {
+    throw std::runtime_error(std::string("Invalid JSON save: ") + ex.what());
+}
+
+void SaveSaxLoader::shapeField(FieldRows& rows, SaveImage::SideImage& side) {
+    // Клетки вне сохраненных строк остаются неизвестными, лишние отбрасываются;
+    // упакованное поле должно совпадать с размерами точно
+    int width = side.width;
+    int height = side.height;
+    if (!rows.packed.empty()) {
+        side.cells.assign(width * height, Status::Unknown);
+        FieldCodec::decodeText(rows.packed, side.cells.data(), side.cells.size());
+        return;
+    }
+    if (rows.rows == height && rows.columns == width) {
+        side.cells = std::move(rows.cells);
+        return;
+    }
+    side.cells.assign(width * height, Status::Unknown);
+    for (int y = 0; y < rows.rows && y < height; ++y) {
+        for (int x = 0; x < rows.columns && x < width; ++x) {
+            side.cells[y * width + x] = rows.cells[y * rows.columns + x];
+        }
+    }
+}
+
+void SaveSaxLoader::finish() {
+    for (int i = 0; i < requiredKeyCount; ++i) {
+        if ((required & (1u << i)) != 0 && (seen & (1u << i)) == 0) {
+            throw std::runtime_error(std::string("Missing key in JSON save: ") + requiredKeys[i]);
+        }
+    }
+    if (image.player.width <= 0 || image.player.height <= 0 || image.bot.width <= 0 || image.bot.height <= 0) {
+        throw std::runtime_error("Invalid field size in JSON save");
+    }
+    if ((sections & PlayerSide) != 0) {
+        shapeField(player_rows, image.player);
+    }
+    if ((sections & BotSide) != 0) {
+        shapeField(bot_rows, image.bot);
+    }
+}
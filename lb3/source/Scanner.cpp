@@ -1,16 +1,35 @@
 #include "Scanner.h"
 #include <iostream>
+#include <algorithm>
 
 void Scanner::apply(GameField& field, ShipManager& manager, Coords coords) {
-    for (int y = coords.y; y < coords.y + 2; ++y) {
-        for (int x = coords.x; x < coords.x + 2; ++x) {
-            if (field.coordinatsInField({x, y}) && field.getField()[y][x].ship_is_here) {
-                std::cout << "Ship segment found at [" << x << "][" << y << "]\n";
+    found_segments.clear();
+    // Корабли окна 2x2 берутся из пространственного индекса поля, а не перебором клеток
+    CellRect window {coords, {coords.x + 1, coords.y + 1}};
+    field.getShipIndex().forEachShip(window, [&](const Ship& ship) {
+        for (const Ship::ShipSegment& segment : ship.getSegments()) {
+            if (segment.coords.x >= window.first.x && segment.coords.x <= window.last.x &&
+                segment.coords.y >= window.first.y && segment.coords.y <= window.last.y) {
+                found_segments.push_back(segment.coords);
             }
         }
+    });
+    std::sort(found_segments.begin(), found_segments.end(), [](Coords a, Coords b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x; // порядок вывода - по строкам, как раньше
+    });
+    for (Coords segment : found_segments) {
+        std::cout << "Ship segment found at [" << segment.x << "][" << segment.y << "]\n";
     }
 }
 
 std::string Scanner::getName() const {
     return "Scanner";
 }
+
+const std::vector<Coords>& Scanner::getFoundSegments() const {
+    return found_segments;
+}
+
+AbilityKind Scanner::getKind() const {
+    return AbilityKind::Scanner;
+}
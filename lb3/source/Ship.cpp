@@ -1,4 +1,5 @@
 #include "Ship.h"
+#include "LiveSegmentIndex.h"
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -28,7 +29,12 @@ Ship::Ship(const Ship& other) { // глубокое копирование
     top_left = other.top_left;
     max_health = other.max_health;
     health = other.health;
+    id = other.id;
     segments = other.segments;
+    relinkSegments();
+    for (auto& segment : segments) {
+        segment.live_slot = -1; // копия не входит в индекс живых сегментов
+    }
 }
 
 Ship::Ship(Ship&& other) noexcept { // Конструктор перемещения
@@ -37,7 +43,11 @@ Ship::Ship(Ship&& other) noexcept { // Конструктор перемещен
     top_left = other.top_left;
     max_health = other.max_health;
     health = other.health;
+    id = other.id;
     segments = move(other.segments);
+    live_index = other.live_index;
+    other.live_index = nullptr;
+    relinkSegments();
 }
 
 Ship& Ship::operator=(const Ship& other) { // оператор присваивания
@@ -50,7 +60,13 @@ Ship& Ship::operator=(const Ship& other) { // оператор присваив
     top_left = other.top_left;
     max_health = other.max_health;
     health = other.health;
+    id = other.id;
     segments = other.segments; // Копируем сегменты
+    live_index = nullptr;
+    relinkSegments();
+    for (auto& segment : segments) {
+        segment.live_slot = -1;
+    }
 
     return *this;
 }
@@ -65,11 +81,23 @@ Ship& Ship::operator=(Ship&& other) noexcept { // оператор присва
     top_left = other.top_left;
     max_health = other.max_health;
     health = other.health;
+    id = other.id;
     segments = std::move(other.segments); // Перемещаем сегменты
+    live_index = other.live_index;
+    other.live_index = nullptr;
+    relinkSegments();
 
     return *this;
 }
 
+int Ship::getId() const {
+    return id;
+}
+
+void Ship::setId(int new_id) {
+    id = new_id;
+}
+
 int Ship::getLength() const {
     return length;
 }
@@ -150,6 +178,7 @@ void Ship::setShipCoordinates(Orientation new_orientation, Coords new_top_left)
 
 
 void Ship::damageSegment(ShipSegment* segment, int damage) {
+    SegmentStatus old_status = segment->status;
     if (segment->status == SegmentStatus::Destroyed) {
         return;
     } else if (segment->status == SegmentStatus::Damaged) {
@@ -157,6 +186,12 @@ void Ship::damageSegment(ShipSegment* segment, int damage) {
     } else if (segment->status == SegmentStatus::Intact) {
         segment->status = (damage >= 2) ? SegmentStatus::Destroyed : SegmentStatus::Damaged;
     }
+    if (live_index != nullptr) {
+        live_index->segmentChanged(segment, old_status);
+        if (segment->status == SegmentStatus::Destroyed && !isAlive()) {
+            live_index->shipSunk(*this); // этим попаданием корабль потоплен
+        }
+    }
     getCurrentHealth(); // Пересчет здоровья после нанесения урона
 }
 
@@ -202,6 +237,41 @@ const std::vector<Ship::ShipSegment>& Ship::getSegments() const {
     return segments;
 }
 
+void Ship::attachLiveIndex(LiveSegmentIndex* index) {
+    live_index = index;
+    if (live_index == nullptr) {
+        return;
+    }
+    for (auto& segment : segments) {
+        if (segment.status != SegmentStatus::Destroyed) {
+            live_index->add(&segment);
+        }
+        if (segment.status != SegmentStatus::Intact) {
+            live_index->segmentChanged(&segment, SegmentStatus::Intact);
+        }
+    }
+    if (!segments.empty() && !isAlive()) {
+        live_index->shipSunk(*this);
+    }
+}
+
+void Ship::restoreSegments(const std::vector<SegmentStatus>& statuses) {
+    if (static_cast<int>(statuses.size()) != length || static_cast<int>(segments.size()) != length) {
+        throw std::invalid_argument("Segment statuses do not match ship length");
+    }
+    health = 0;
+    for (int i = 0; i < length; ++i) {
+        segments[i].status = statuses[i];
+        health += statuses[i] == SegmentStatus::Intact ? 2 : (statuses[i] == SegmentStatus::Damaged ? 1 : 0);
+    }
+}
+
+void Ship::relinkSegments() { // после копирования/перемещения сегменты должны указывать на новый объект
+    for (auto& segment : segments) {
+        segment.ship_pointer = this;
+    }
+}
+
 
 string segmentStatusToString(SegmentStatus status) { // Чтобы правильно вывести статус сегмента, конвертируем значение SegmentStatus в строку
     switch (status) {
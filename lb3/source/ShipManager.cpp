@@ -1,29 +1,18 @@
 #include "ShipManager.h"
 
-ShipManager::ShipManager(std::vector<int> sizes) {
+ShipManager::ShipManager(std::vector<int> sizes) : live_segments(std::make_unique<LiveSegmentIndex>()) {
     for (int size : sizes) {
         free_ships.emplace_back(size);
     }
 }
 
+// Потопления считает индекс сегментов, поэтому подсчет не обходит флот
 int ShipManager::getAliveShipsNumber() {
-    int shipNum = 0;
-    for (const auto& ship : active_ships) {
-        if (ship.isAlive()) {
-            shipNum++;
-        }
-    }
-    return shipNum;
+    return active_ships.size() - live_segments->getSunkCount();
 }
 
 int ShipManager::getDestroyedShipsNumber() {
-    int shipNum = 0;
-    for (const auto& ship : active_ships) {
-        if (!(ship.isAlive())) {
-            shipNum++;
-        }
-    }
-    return shipNum;
+    return live_segments->getSunkCount();
 }
 
 int ShipManager::getShipCount() const {
@@ -60,6 +49,8 @@ void ShipManager::moveShipToActive(int index) {
     if (index >= 0 && index < free_ships.size()) {
         active_ships.push_back(std::move(free_ships[index]));
         free_ships.erase(free_ships.begin() + index);
+        active_ships.back().setId(active_ships.size() - 1);
+        active_ships.back().attachLiveIndex(live_segments.get());
     } else {
         throw std::out_of_range("Invalid index for moving ship");
     }
@@ -72,3 +63,19 @@ std::vector<int> ShipManager::getShipSizes() {
     }
     return sizes;
 }
+
+Ship::ShipSegment* ShipManager::getLiveSegment(int index) {
+    return live_segments->get(index);
+}
+
+Ship::ShipSegment* ShipManager::getRandomLiveSegment() {
+    return live_segments->getRandom();
+}
+
+int ShipManager::getLiveSegmentCount() const {
+    return live_segments->size();
+}
+
+std::uint64_t ShipManager::getHash() const {
+    return live_segments->getHash();
+}
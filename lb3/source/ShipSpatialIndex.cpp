@@ -0,0 +1,94 @@
+#include "ShipSpatialIndex.h"
+#include <cstdlib>
+
+ShipSpatialIndex::ShipSpatialIndex(int width, int height)
+    : columns((width + bucketSide - 1) >> bucketShift),
+      rows((height + bucketSide - 1) >> bucketShift),
+      buckets(static_cast<std::size_t>(columns) * rows) {}
+
+CellRect ShipSpatialIndex::extent(const Ship& ship) {
+    CellRect rect {ship.getCoords(), ship.getCoords()};
+    if (ship.getOrientation() == Orientation::Vertical) {
+        rect.last.y += ship.getLength() - 1;
+    } else {
+        rect.last.x += ship.getLength() - 1;
+    }
+    return rect;
+}
+
+bool ShipSpatialIndex::intersects(const CellRect& a, const CellRect& b) {
+    return a.first.x <= b.last.x && b.first.x <= a.last.x && a.first.y <= b.last.y && b.first.y <= a.last.y;
+}
+
+int ShipSpatialIndex::distance(Coords point, const CellRect& rect) {
+    int dx = std::max({rect.first.x - point.x, 0, point.x - rect.last.x});
+    int dy = std::max({rect.first.y - point.y, 0, point.y - rect.last.y});
+    return std::max(dx, dy);
+}
+
+void ShipSpatialIndex::add(const Ship& ship) {
+    if (ship.getSegments().empty()) {
+        return;
+    }
+    CellRect area = extent(ship);
+    for (int row = area.first.y >> bucketShift; row <= (area.last.y >> bucketShift); ++row) {
+        for (int column = area.first.x >> bucketShift; column <= (area.last.x >> bucketShift); ++column) {
+            buckets[row * columns + column].push_back(ship.getSegmentByIndex(0));
+        }
+    }
+}
+
+void ShipSpatialIndex::clear() {
+    for (std::vector<const Ship::ShipSegment*>& bucket : buckets) {
+        bucket.clear();
+    }
+}
+
+std::vector<const Ship*> ShipSpatialIndex::shipsIn(CellRect rect) const {
+    std::vector<const Ship*> found;
+    forEachShip(rect, [&](const Ship& ship) {
+        found.push_back(&ship);
+    });
+    return found;
+}
+
+const Ship* ShipSpatialIndex::nearestAliveShip(Coords point) const {
+    if (buckets.empty()) {
+        return nullptr;
+    }
+    int center_column = std::min(std::max(point.x >> bucketShift, 0), columns - 1);
+    int center_row = std::min(std::max(point.y >> bucketShift, 0), rows - 1);
+    const Ship* best = nullptr;
+    int best_distance = 0;
+    int rings = std::max(columns, rows);
+    for (int ring = 0; ring < rings; ++ring) {
+        // Клетки корзин кольца ring не ближе (ring - 1) * bucketSide + 1: дальше искать незачем
+        if (best != nullptr && best_distance <= (ring - 1) * bucketSide) {
+            break;
+        }
+        for (int row = center_row - ring; row <= center_row + ring; ++row) {
+            if (row < 0 || row >= rows) {
+                continue;
+            }
+            // Внутри кольца - только левая и правая корзины строки, на краях - вся строка
+            int step = (row == center_row - ring || row == center_row + ring) ? 1 : std::max(2 * ring, 1);
+            for (int column = center_column - ring; column <= center_column + ring; column += step) {
+                if (column < 0 || column >= columns) {
+                    continue;
+                }
+                for (const Ship::ShipSegment* bow : buckets[row * columns + column]) {
+                    const Ship& ship = *bow->ship_pointer;
+                    if (!ship.isAlive()) {
+                        continue;
+                    }
+                    int candidate = distance(point, extent(ship));
+                    if (best == nullptr || candidate < best_distance) {
+                        best = &ship;
+                        best_distance = candidate;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
@@ -1,25 +1,114 @@
 #include <iostream>
 
 #include <stdexcept>
+#include <fstream>
+#include <memory>
+#include <ctime>
+#include <cstdlib>
 #include "Game.h"
 #include "GameState.h"
 
 using namespace std;
 
-//////////////////////////  g++ -I lb3/include lb3/source/GameField.cpp lb3/source/Ship.cpp lb3/source/ShipManager.cpp lb3/source/main.cpp lb3/source/Bombardment.cpp lb3/source/DoubleDamage.cpp  lb3/source/Scanner.cpp lb3/source/AbilityManager.cpp lb3/source/Game.cpp lb3/source/FileHandler.cpp lb3/source/FileExeption.cpp lb3/source/GameState.cpp -o build_lb/lb3
-int main() {
+//////////////////////////  g++ -I lb3/include lb3/source/GameField.cpp lb3/source/Ship.cpp lb3/source/ShipManager.cpp lb3/source/main.cpp lb3/source/Bombardment.cpp lb3/source/DoubleDamage.cpp  lb3/source/Scanner.cpp lb3/source/AbilityManager.cpp lb3/source/Game.cpp lb3/source/FileHandler.cpp lb3/source/FileExeption.cpp lb3/source/GameState.cpp lb3/source/LiveSegmentIndex.cpp lb3/source/ProbabilityMap.cpp lb3/source/EnemyAI.cpp lb3/source/MctsAI.cpp lb3/source/SaveImage.cpp lb3/source/BinarySave.cpp lb3/source/SaveSaxLoader.cpp lb3/source/JsonSaveWriter.cpp lb3/source/SaveJournal.cpp lb3/source/AsyncSaver.cpp lb3/source/SaveArchive.cpp lb3/source/FieldCodec.cpp lb3/source/GameStateView.cpp lb3/source/BoardRenderer.cpp lb3/source/AnsiDiffRenderer.cpp lb3/source/PlayerInput.cpp lb3/source/ConsolePolicies.cpp lb3/source/ShipSpatialIndex.cpp -o build_lb/lb3
+Difficulty parseDifficulty(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        string option = argv[i];
+        string value = argv[i + 1];
+        if (option == "--difficulty") {
+            if (value == "easy") return Difficulty::Easy;
+            if (value == "hard") return Difficulty::Hard;
+        }
+    }
+    return Difficulty::Normal;
+}
+
+SaveFormat parseSaveFormat(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        string option = argv[i];
+        string value = argv[i + 1];
+        if (option == "--save-format") {
+            if (value == "json") return SaveFormat::Json;
+            if (value == "binary") return SaveFormat::Binary;
+            if (value == "journal") return SaveFormat::Journal;
+        }
+    }
+    return SaveFormat::Auto;
+}
+
+string parseAutosave(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--autosave") {
+            return argv[i + 1];
+        }
+    }
+    return "";
+}
+
+bool parseAnsi(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--ansi") {
+            return true;
+        }
+    }
+    return false;
+}
+
+string parseOption(int argc, char* argv[], const string& name) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) {
+            return argv[i + 1];
+        }
+    }
+    return "";
+}
+
+// --script <файл|-> - решения игрока из сценария, --results <файл|-> - события игры построчно,
+// --seed <число> - повторяемые ходы врага и выдача способностей
+int main(int argc, char* argv[]) {
+    string seed = parseOption(argc, argv, "--seed");
+    srand(seed.empty() ? time(0) : strtoul(seed.c_str(), nullptr, 10));
+
     try {
+        shared_ptr<PlayerInput> input = make_shared<ConsoleInput>();
+        ifstream script_file;
+        ofstream results_file;
+        string script = parseOption(argc, argv, "--script");
+        if (!script.empty()) {
+            string results = parseOption(argc, argv, "--results");
+            ostream* results_stream = nullptr;
+            if (results == "-") {
+                results_stream = &cout;
+            } else if (!results.empty()) {
+                results_file.open(results);
+                results_stream = &results_file;
+            }
+            if (script != "-") {
+                script_file.open(script);
+                if (!script_file.is_open()) {
+                    throw runtime_error("Can't open script " + script);
+                }
+            }
+            input = make_shared<ScriptInput>(script == "-" ? cin : script_file, results_stream);
+        }
+
         Game game;
-        cout << "Хотите загрузить сохраненную игру? (y/n): ";
-        char answer;
-        cin >> answer;
-        if (answer == 'y') {
-            string file_name;
-            cout << "Введите имя файла загрузки: ";
-            cin >> file_name;
+        game.setDifficulty(parseDifficulty(argc, argv));
+        game.setSaveFormat(parseSaveFormat(argc, argv));
+        game.setAutosaveFile(parseAutosave(argc, argv));
+        game.setAnsiRendering(parseAnsi(argc, argv));
+        game.setInput(input);
+        if (input->ask(InputStep::LoadGame)) {
+            string file_name = input->readFileName(InputStep::LoadGame);
             GameState gameState(file_name);
             game = gameState.load();
+            game.setDifficulty(parseDifficulty(argc, argv));
+            game.setSaveFormat(parseSaveFormat(argc, argv));
+            game.setAutosaveFile(parseAutosave(argc, argv));
+            game.setAnsiRendering(parseAnsi(argc, argv));
+            game.setInput(input);
             cout << "Игра успешно загружена!\n";
+            input->report("load ok " + file_name);
             game.startGame(1);
         }
         else{
@@ -27,8 +116,10 @@ int main() {
         }
     } catch (const exception& e) {
         cerr << "An error occurred: " << e.what() << "\n";
+        return 1; // прогоны сценариев отличают ошибку от законченной игры по коду возврата
     } catch (...) {
         cerr << "An unknown error occurred.\n";
+        return 1;
     }
     return 0;
 }